@@ -0,0 +1,384 @@
+// fxBench.cpp
+// Micro-benchmarks for the fxDrawingContext / fxGraphicsPath hot paths.
+//
+// Usage: fxBench [--filter text] [--min-time ms] [--csv]
+//
+// Every benchmark runs for each size parameter and, where it draws, on each
+// backend: wxGraphicsContext on a memory DC, plain wxMemoryDC and wxSVGFileDC.
+// Reported: ns per operation, processed items per second (vertices, points
+// or characters) and heap allocations per operation.
+
+#include <wx/app.h>
+#include <wx/dcmemory.h>
+#include <wx/dcsvg.h>
+#include <wx/filename.h>
+#include <wx/graphics.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#include "fxDrawingContext.hpp"
+#include "fxGraphicsPath.hpp"
+
+//--------------------------------------
+// Allocation counting
+//--------------------------------------
+namespace {
+std::atomic<size_t> g_allocCount{0};
+std::atomic<size_t> g_allocBytes{0};
+}
+
+void* operator new(std::size_t size)
+{
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+//--------------------------------------
+// Harness
+//--------------------------------------
+struct BenchOptions
+{
+    std::string filter;
+    double minTimeMs = 200.0;
+    bool csv = false;
+};
+
+struct BenchResult
+{
+    std::string name;
+    std::string backend;
+    size_t size = 0;
+    double nsPerOp = 0.0;
+    double itemsPerSec = 0.0;
+    double allocsPerOp = 0.0;
+    double bytesPerOp = 0.0;
+};
+
+using Clock = std::chrono::steady_clock;
+
+// Run op() in growing batches until minTimeMs is reached.
+// itemsPerOp is what one call processes (for the items/s figure).
+BenchResult Measure(const BenchOptions& opt, const std::string& name, const std::string& backend,
+                    size_t size, size_t itemsPerOp, const std::function<void()>& op)
+{
+    op();  // warm-up: caches, lazy native objects
+
+    size_t iterations = 1;
+    for (;;)
+    {
+        const size_t allocs0 = g_allocCount.load(std::memory_order_relaxed);
+        const size_t bytes0  = g_allocBytes.load(std::memory_order_relaxed);
+        const auto start = Clock::now();
+
+        for (size_t i = 0; i < iterations; ++i) op();
+
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        if (ns >= opt.minTimeMs * 1e6 || iterations >= (size_t(1) << 30))
+        {
+            BenchResult r;
+            r.name        = name;
+            r.backend     = backend;
+            r.size        = size;
+            r.nsPerOp     = ns / iterations;
+            r.itemsPerSec = itemsPerOp * 1e9 / r.nsPerOp;
+            r.allocsPerOp = double(g_allocCount.load(std::memory_order_relaxed) - allocs0) / iterations;
+            r.bytesPerOp  = double(g_allocBytes.load(std::memory_order_relaxed) - bytes0) / iterations;
+            return r;
+        }
+
+        // Aim a bit past the target, at most 10x per round
+        const double scale = ns > 0.0 ? 1.2 * opt.minTimeMs * 1e6 / ns : 10.0;
+        iterations = size_t(std::ceil(iterations * std::min(10.0, std::max(2.0, scale))));
+    }
+}
+
+void Print(const BenchOptions& opt, const BenchResult& r)
+{
+    if (opt.csv) {
+        std::printf("%s,%s,%zu,%.1f,%.0f,%.2f,%.0f\n", r.name.c_str(), r.backend.c_str(), r.size,
+                    r.nsPerOp, r.itemsPerSec, r.allocsPerOp, r.bytesPerOp);
+    } else {
+        std::printf("%-18s %-8s %7zu %14.1f %14.0f %10.2f %12.0f\n", r.name.c_str(), r.backend.c_str(), r.size,
+                    r.nsPerOp, r.itemsPerSec, r.allocsPerOp, r.bytesPerOp);
+    }
+    std::fflush(stdout);
+}
+
+//--------------------------------------
+// Backends
+//--------------------------------------
+const int CANVAS_SIZE = 512;
+
+// A drawing target that lives for the whole benchmark
+struct Backend
+{
+    std::string name;
+    wxBitmap bitmap;
+    std::unique_ptr<wxMemoryDC> memDC;
+    std::unique_ptr<wxSVGFileDC> svgDC;
+    std::unique_ptr<wxGraphicsContext> gc;
+    std::unique_ptr<fxDrawingContext> ctx;
+
+    wxDC* GetDC() const { return svgDC ? static_cast<wxDC*>(svgDC.get()) : memDC.get(); }
+};
+
+wxString TempSvgPath()
+{
+    return wxFileName(wxFileName::GetTempDir(), "fxBench.svg").GetFullPath();
+}
+
+std::vector<std::unique_ptr<Backend>> CreateBackends()
+{
+    std::vector<std::unique_ptr<Backend>> backends;
+
+    auto gcBackend = std::make_unique<Backend>();
+    gcBackend->name   = "gc";
+    gcBackend->bitmap = wxBitmap(CANVAS_SIZE, CANVAS_SIZE);
+    gcBackend->memDC  = std::make_unique<wxMemoryDC>(gcBackend->bitmap);
+    gcBackend->gc.reset(wxGraphicsContext::Create(*gcBackend->memDC));
+    gcBackend->ctx    = std::make_unique<fxDrawingContext>(gcBackend->gc.get());
+    backends.push_back(std::move(gcBackend));
+
+    auto dcBackend = std::make_unique<Backend>();
+    dcBackend->name   = "memdc";
+    dcBackend->bitmap = wxBitmap(CANVAS_SIZE, CANVAS_SIZE);
+    dcBackend->memDC  = std::make_unique<wxMemoryDC>(dcBackend->bitmap);
+    // Without a GC on top: the wxDC fallback paths are what this row measures
+    dcBackend->ctx    = std::make_unique<fxDrawingContext>(dcBackend->memDC.get(), false);
+    backends.push_back(std::move(dcBackend));
+
+    // Output grows with every call; the file is written when the DC goes away
+    auto svgBackend = std::make_unique<Backend>();
+    svgBackend->name  = "svg";
+    svgBackend->svgDC = std::make_unique<wxSVGFileDC>(TempSvgPath(), CANVAS_SIZE, CANVAS_SIZE);
+    svgBackend->ctx   = std::make_unique<fxDrawingContext>(svgBackend->svgDC.get());
+    backends.push_back(std::move(svgBackend));
+
+    return backends;
+}
+
+//--------------------------------------
+// Inputs
+//--------------------------------------
+const size_t SIZES[] = {16, 256, 4096};
+
+// n cubic segments along a sine wave, inside the canvas
+fxGraphicsPath MakeWavePath(wxGraphicsContext* gc, size_t n)
+{
+    fxGraphicsPath path(gc);
+    const double dx = double(CANVAS_SIZE) / n;
+    path.MoveToPoint(0, CANVAS_SIZE / 2);
+    for (size_t i = 0; i < n; ++i) {
+        const double x = (i + 1) * dx;
+        const double y = CANVAS_SIZE / 2 + 100 * std::sin(x * 0.05);
+        path.AddCurveToPoint(x - 0.66 * dx, y - 20, x - 0.33 * dx, y + 20, x, y);
+    }
+    return path;
+}
+
+std::vector<wxPoint2DDouble> MakePolyline(size_t n)
+{
+    std::vector<wxPoint2DDouble> points(n);
+    for (size_t i = 0; i < n; ++i) {
+        const double x = double(i) * CANVAS_SIZE / n;
+        points[i] = wxPoint2DDouble(x, CANVAS_SIZE / 2 + 100 * std::sin(x * 0.05));
+    }
+    return points;
+}
+
+bool Selected(const BenchOptions& opt, const std::string& name)
+{
+    return opt.filter.empty() || name.find(opt.filter) != std::string::npos;
+}
+
+//--------------------------------------
+// Benchmarks
+//--------------------------------------
+void BenchPathBuild(const BenchOptions& opt, Backend& b)
+{
+    if (!Selected(opt, "PathBuild")) return;
+    for (size_t n : SIZES) {
+        Print(opt, Measure(opt, "PathBuild", b.name, n, n, [&]() {
+            fxGraphicsPath path = b.ctx->CreatePath();
+            path.MoveToPoint(0, 0);
+            for (size_t i = 0; i < n; ++i) {
+                path.AddLineToPoint(double(i), double(i & 63));
+            }
+        }));
+    }
+}
+
+void BenchFlatten(const BenchOptions& opt)
+{
+    // The step count is the parameter: items are emitted vertices
+    for (size_t n : SIZES)
+    {
+        const int steps = static_cast<int>(n);
+        if (Selected(opt, "ApproxArc")) {
+            Print(opt, Measure(opt, "ApproxArc", "-", n, n, [&]() {
+                auto pts = ApproxArc(wxPoint2DDouble(100, 100), 50, 0, M_PI, false, steps);
+                if (pts.empty()) std::abort();
+            }));
+        }
+        if (Selected(opt, "ApproxQuad")) {
+            Print(opt, Measure(opt, "ApproxQuad", "-", n, n, [&]() {
+                auto pts = ApproxQuadBezier({0, 0}, {50, 100}, {100, 0}, steps);
+                if (pts.empty()) std::abort();
+            }));
+        }
+        if (Selected(opt, "ApproxCubic")) {
+            Print(opt, Measure(opt, "ApproxCubic", "-", n, n, [&]() {
+                auto pts = ApproxCubicBezier({0, 0}, {30, 100}, {70, -100}, {100, 0}, steps);
+                if (pts.empty()) std::abort();
+            }));
+        }
+    }
+}
+
+void BenchDrawPathOnDC(const BenchOptions& opt, Backend& b)
+{
+    // The wxDC fallback only: never under a live GC
+    if (!Selected(opt, "DrawPathOnDC") || !b.ctx->IsDC()) return;
+    for (size_t n : SIZES) {
+        const fxGraphicsPath path = MakeWavePath(nullptr, n);
+        const size_t vertices = CountFlattenedVertices(path);
+        Print(opt, Measure(opt, "DrawPathOnDC", b.name, n, vertices, [&]() {
+            DrawPathOnDC(b.GetDC(), path);
+        }));
+    }
+}
+
+void BenchStrokePath(const BenchOptions& opt, Backend& b)
+{
+    if (!Selected(opt, "StrokePath")) return;
+    b.ctx->SetPen(*wxBLACK_PEN);
+    for (size_t n : SIZES) {
+        const fxGraphicsPath path = MakeWavePath(b.gc.get(), n);
+        const size_t vertices = CountFlattenedVertices(path);
+        Print(opt, Measure(opt, "StrokePath", b.name, n, vertices, [&]() {
+            b.ctx->StrokePath(path);
+        }));
+    }
+}
+
+void BenchTextExtent(const BenchOptions& opt, Backend& b)
+{
+    if (!Selected(opt, "TextExtent")) return;
+    b.ctx->SetFont(*wxNORMAL_FONT, *wxBLACK);
+    for (size_t n : SIZES) {
+        const wxString text('x', n);
+        Print(opt, Measure(opt, "TextExtent", b.name, n, n, [&]() {
+            wxDouble w = 0.0, h = 0.0;
+            b.ctx->GetTextExtent(text, &w, &h);
+        }));
+    }
+}
+
+void BenchStrokeLines(const BenchOptions& opt, Backend& b)
+{
+    if (!Selected(opt, "StrokeLines")) return;
+    b.ctx->SetPen(*wxBLACK_PEN);
+    for (size_t n : SIZES) {
+        const auto points = MakePolyline(n);
+        Print(opt, Measure(opt, "StrokeLines", b.name, n, n, [&]() {
+            b.ctx->StrokeLines(points.size(), points.data());
+        }));
+    }
+}
+
+// Whole SVG document: create the DC, draw n polylines, write the file
+void BenchSvgExport(const BenchOptions& opt)
+{
+    if (!Selected(opt, "SvgExport")) return;
+    const wxString filename = TempSvgPath();
+    const auto points = MakePolyline(256);
+
+    for (size_t n : SIZES) {
+        Print(opt, Measure(opt, "SvgExport", "svg", n, n * points.size(), [&]() {
+            wxSVGFileDC dc(filename, CANVAS_SIZE, CANVAS_SIZE);
+            fxDrawingContext ctx(&dc);
+            ctx.SetPen(*wxBLACK_PEN);
+            for (size_t i = 0; i < n; ++i) {
+                ctx.StrokeLines(points.size(), points.data());
+            }
+        }));
+    }
+    wxRemoveFile(filename);
+}
+
+} // namespace
+
+//--------------------------------------
+// Application
+//--------------------------------------
+class fxBenchApp : public wxApp
+{
+public:
+    bool OnInit() override
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const wxString arg = argv[i];
+            if (arg == "--filter" && i + 1 < argc) {
+                m_options.filter = argv[++i].ToStdString();
+            } else if (arg == "--min-time" && i + 1 < argc) {
+                m_options.minTimeMs = std::atof(argv[++i].mb_str());
+            } else if (arg == "--csv") {
+                m_options.csv = true;
+            } else {
+                std::fprintf(stderr, "usage: fxBench [--filter text] [--min-time ms] [--csv]\n");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // No event loop: run the benchmarks and exit
+    int OnRun() override
+    {
+        const BenchOptions& opt = m_options;
+        if (opt.csv) {
+            std::printf("name,backend,size,ns_per_op,items_per_s,allocs_per_op,bytes_per_op\n");
+        } else {
+            std::printf("%-18s %-8s %7s %14s %14s %10s %12s\n",
+                        "benchmark", "backend", "size", "ns/op", "items/s", "allocs/op", "bytes/op");
+        }
+
+        BenchFlatten(opt);
+
+        auto backends = CreateBackends();
+        for (auto& b : backends)
+        {
+            BenchPathBuild(opt, *b);
+            BenchDrawPathOnDC(opt, *b);
+            BenchStrokePath(opt, *b);
+            BenchTextExtent(opt, *b);
+            BenchStrokeLines(opt, *b);
+        }
+        backends.clear();
+        wxRemoveFile(TempSvgPath());
+
+        BenchSvgExport(opt);
+        return 0;
+    }
+
+private:
+    BenchOptions m_options;
+};
+
+wxIMPLEMENT_APP(fxBenchApp);
@@ -0,0 +1,153 @@
+// fxBitmapCache.cpp
+#include "fxBitmapCache.hpp"
+#include <algorithm>
+
+namespace {
+
+size_t PixelBytes(int width, int height)
+{
+    return size_t(std::max(width, 0)) * size_t(std::max(height, 0)) * 4;
+}
+
+} // namespace
+
+fxBitmapCache::fxBitmapCache(size_t budgetBytes)
+    : m_budget(budgetBytes)
+{
+}
+
+//--------------------------------------
+// Lookups
+//--------------------------------------
+wxBitmap fxBitmapCache::GetScaled(const wxBitmap& bitmap, const wxSize& size, wxImageResizeQuality quality)
+{
+    if (!bitmap.IsOk() || size.GetWidth() <= 0 || size.GetHeight() <= 0) return bitmap;
+    if (size == bitmap.GetSize()) return bitmap;
+
+    Entry& entry = Lookup(bitmap);
+
+    for (const Scaled& scaled : entry.scaled) {
+        if (scaled.size == size && scaled.quality == quality) {
+            ++m_hits;
+            return scaled.bitmap;
+        }
+    }
+    ++m_misses;
+
+    const wxImage& mip = entry.mips[MipLevel(entry, size)];
+    const wxBitmap result = mip.GetWidth() == size.GetWidth() && mip.GetHeight() == size.GetHeight()
+                          ? wxBitmap(mip)
+                          : wxBitmap(mip.Scale(size.GetWidth(), size.GetHeight(), quality));
+
+    entry.scaled.push_back({size, quality, result});
+    Account(entry, PixelBytes(size.GetWidth(), size.GetHeight()));
+    Evict(bitmap.GetRefData());
+    return result;
+}
+
+wxBitmap fxBitmapCache::GetMipLevel(const wxBitmap& bitmap, const wxSize& size)
+{
+    // Not worth an entry unless at least one level down
+    if (!bitmap.IsOk() ||
+        bitmap.GetWidth() < 2 * size.GetWidth() || bitmap.GetHeight() < 2 * size.GetHeight()) {
+        return bitmap;
+    }
+
+    Entry& entry = Lookup(bitmap);
+
+    const size_t level = MipLevel(entry, size);
+    if (level == 0) return bitmap;
+
+    if (entry.mipBitmaps.size() <= level) entry.mipBitmaps.resize(level + 1);
+    if (entry.mipBitmaps[level].IsOk()) {
+        ++m_hits;
+        return entry.mipBitmaps[level];
+    }
+    ++m_misses;
+
+    const wxImage& mip = entry.mips[level];
+    entry.mipBitmaps[level] = wxBitmap(mip);
+    Account(entry, PixelBytes(mip.GetWidth(), mip.GetHeight()));
+
+    const wxBitmap result = entry.mipBitmaps[level];
+    Evict(bitmap.GetRefData());
+    return result;
+}
+
+fxBitmapCache::Entry& fxBitmapCache::Lookup(const wxBitmap& bitmap)
+{
+    Entry& entry = m_entries[bitmap.GetRefData()];
+    if (!entry.source.IsOk()) entry.source = bitmap;
+    entry.lastUse = ++m_clock;
+    return entry;
+}
+
+size_t fxBitmapCache::MipLevel(Entry& entry, const wxSize& size)
+{
+    if (entry.mips.empty()) {
+        entry.mips.push_back(entry.source.ConvertToImage());
+        Account(entry, PixelBytes(entry.mips[0].GetWidth(), entry.mips[0].GetHeight()));
+    }
+
+    size_t level = 0;
+    for (;;) {
+        const int halfWidth  = entry.mips[level].GetWidth() / 2;
+        const int halfHeight = entry.mips[level].GetHeight() / 2;
+        if (halfWidth < std::max(1, size.GetWidth()) || halfHeight < std::max(1, size.GetHeight())) return level;
+
+        if (level + 1 == entry.mips.size()) {
+            wxImage half = entry.mips[level].ShrinkBy(2, 2);
+            entry.mips.push_back(half);
+            Account(entry, PixelBytes(halfWidth, halfHeight));
+        }
+        ++level;
+    }
+}
+
+//--------------------------------------
+// Budget
+//--------------------------------------
+void fxBitmapCache::Account(Entry& entry, size_t bytes)
+{
+    entry.bytes += bytes;
+    m_bytes += bytes;
+}
+
+void fxBitmapCache::Evict(const void* keep)
+{
+    // Least recently used bitmaps first
+    while (m_bytes > m_budget) {
+        auto oldest = m_entries.end();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->first != keep && (oldest == m_entries.end() || it->second.lastUse < oldest->second.lastUse)) {
+                oldest = it;
+            }
+        }
+        if (oldest == m_entries.end()) break;
+        m_bytes -= oldest->second.bytes;
+        m_entries.erase(oldest);
+    }
+
+    // Then the older sizes of the bitmap in use (e.g. during a zoom)
+    auto it = m_entries.find(keep);
+    if (it == m_entries.end()) return;
+    Entry& entry = it->second;
+    while (m_bytes > m_budget && entry.scaled.size() > 1) {
+        const size_t bytes = PixelBytes(entry.scaled.front().size.GetWidth(), entry.scaled.front().size.GetHeight());
+        entry.scaled.erase(entry.scaled.begin());
+        entry.bytes -= bytes;
+        m_bytes -= bytes;
+    }
+}
+
+void fxBitmapCache::SetBudget(size_t bytes)
+{
+    m_budget = bytes;
+    Evict(nullptr);
+}
+
+void fxBitmapCache::Clear()
+{
+    m_entries.clear();
+    m_bytes = 0;
+}
@@ -0,0 +1,80 @@
+// fxBitmapCache.hpp
+
+#ifndef FXBITMAPCACHE_HPP
+#define FXBITMAPCACHE_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <wx/bitmap.h>
+#include <wx/image.h>
+
+// Scaled copies of bitmaps, kept between frames.
+//
+// Entries are keyed by the bitmap's shared data, so copies of a wxBitmap hit
+// the same entry while a modified bitmap (which wx unshares) gets a new one.
+// Each entry keeps a mip chain of the source (every level half the previous
+// one, box filtered) and the scaled versions asked for. A scaled version is
+// made from the smallest mip level that is still at least the target size,
+// which keeps large reductions cheap and free of aliasing.
+//
+// The cache holds at most GetBudget() bytes of pixels (4 bytes per pixel);
+// the least recently used bitmaps are dropped first. An entry holds a
+// reference to its source bitmap, so drawing into that bitmap afterwards
+// copies it first: cache bitmaps that stay unchanged, and Clear() the cache
+// when they go away. Like wxBitmap itself, it is for the GUI thread only.
+class fxBitmapCache
+{
+public:
+    explicit fxBitmapCache(size_t budgetBytes = 64 * 1024 * 1024);
+
+    // Bitmap resized to size with the given quality
+    wxBitmap GetScaled(const wxBitmap& bitmap, const wxSize& size,
+                       wxImageResizeQuality quality = wxIMAGE_QUALITY_NORMAL);
+
+    // Smallest mip level of bitmap that is at least size in both directions
+    // (the bitmap itself when it is not twice as large)
+    wxBitmap GetMipLevel(const wxBitmap& bitmap, const wxSize& size);
+
+    void SetBudget(size_t bytes);
+    size_t GetBudget() const { return m_budget; }
+    size_t GetBytes() const { return m_bytes; }
+
+    size_t GetHits() const { return m_hits; }
+    size_t GetMisses() const { return m_misses; }
+
+    void Clear();
+
+private:
+    struct Scaled
+    {
+        wxSize size;
+        wxImageResizeQuality quality;
+        wxBitmap bitmap;
+    };
+
+    struct Entry
+    {
+        wxBitmap source;                // keeps the key alive
+        std::vector<wxImage>  mips;     // level 0 = source image, built on demand
+        std::vector<wxBitmap> mipBitmaps;
+        std::vector<Scaled>   scaled;
+        size_t   bytes = 0;
+        uint64_t lastUse = 0;
+    };
+
+    std::unordered_map<const void*, Entry> m_entries;
+    size_t   m_budget;
+    size_t   m_bytes = 0;
+    uint64_t m_clock = 0;
+    size_t   m_hits = 0;
+    size_t   m_misses = 0;
+
+    Entry& Lookup(const wxBitmap& bitmap);
+    // Mip level for size, building the chain as far as needed
+    size_t MipLevel(Entry& entry, const wxSize& size);
+    void Account(Entry& entry, size_t bytes);
+    void Evict(const void* keep);
+};
+
+#endif // FXBITMAPCACHE_HPP
@@ -0,0 +1,343 @@
+// fxColormap.cpp
+#include "fxColormap.hpp"
+#include "fxSimd.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Values normalized and coloured per batch (indices kept on the stack)
+const size_t CHUNK = 256;
+
+uint32_t Pack(const wxColour& c)
+{
+    return uint32_t(c.Red()) | uint32_t(c.Green()) << 8 | uint32_t(c.Blue()) << 16 | uint32_t(c.Alpha()) << 24;
+}
+
+unsigned char Lerp(unsigned char a, unsigned char b, double t)
+{
+    return static_cast<unsigned char>(std::lround(a + (b - a) * t));
+}
+
+inline void Store(uint32_t rgba, unsigned char* rgb, unsigned char* alpha)
+{
+    rgb[0] = static_cast<unsigned char>(rgba);
+    rgb[1] = static_cast<unsigned char>(rgba >> 8);
+    rgb[2] = static_cast<unsigned char>(rgba >> 16);
+    if (alpha) *alpha = static_cast<unsigned char>(rgba >> 24);
+}
+
+// Table index of a normalized position; NaN (a degenerate range) gives 0
+int32_t ClampIndex(double t, double top)
+{
+    return !(t > 0.0) ? 0 : t >= top ? static_cast<int32_t>(top) : static_cast<int32_t>(t);
+}
+
+#if FX_SIMD_AVX2
+FX_TARGET_AVX2 inline __m256d Load4(const double* p) { return _mm256_loadu_pd(p); }
+FX_TARGET_AVX2 inline __m256d Load4(const float* p)  { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+
+// Linear-scale indices of whole groups of 4 values; returns the count done
+template <typename T>
+FX_TARGET_AVX2
+size_t LinearIndicesAVX2(const T* values, size_t n, double vmin, double vmax, double scale, double top,
+                         int32_t nanIndex, int32_t underIndex, int32_t overIndex, int32_t* index)
+{
+    const __m256d min    = _mm256_set1_pd(vmin);
+    const __m256d max    = _mm256_set1_pd(vmax);
+    const __m256d scl    = _mm256_set1_pd(scale);
+    const __m256d zero   = _mm256_setzero_pd();
+    const __m256d last   = _mm256_set1_pd(top);
+    const __m256d nanV   = _mm256_set1_pd(double(nanIndex));
+    const __m256d underV = _mm256_set1_pd(double(underIndex));
+    const __m256d overV  = _mm256_set1_pd(double(overIndex));
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d v = Load4(values + i);
+        __m256d t = _mm256_mul_pd(_mm256_sub_pd(v, min), scl);
+        t = _mm256_min_pd(_mm256_max_pd(t, zero), last);
+        t = _mm256_blendv_pd(t, underV, _mm256_cmp_pd(v, min, _CMP_LT_OQ));
+        t = _mm256_blendv_pd(t, overV, _mm256_cmp_pd(v, max, _CMP_GT_OQ));
+        t = _mm256_blendv_pd(t, nanV, _mm256_cmp_pd(v, v, _CMP_UNORD_Q));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(index + i), _mm256_cvttpd_epi32(t));
+    }
+    return i;
+}
+
+// out[i] = table[index[i]] for whole groups of 8; returns the count done
+FX_TARGET_AVX2
+size_t GatherAVX2(const uint32_t* table, const int32_t* index, size_t n, uint32_t* out)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), k, 4));
+    }
+    return i;
+}
+#endif
+
+} // namespace
+
+//--------------------------------------
+// Construction
+//--------------------------------------
+fxColormap::fxColormap()
+    : fxColormap(Viridis())
+{
+}
+
+fxColormap::fxColormap(const std::vector<fxColormapStop>& stops, size_t tableSize)
+    : m_stops(stops), m_size(std::max<size_t>(2, tableSize))
+{
+    std::stable_sort(m_stops.begin(), m_stops.end(),
+                     [](const fxColormapStop& a, const fxColormapStop& b) { return a.position < b.position; });
+    BuildTable();
+}
+
+fxColormap fxColormap::Viridis()
+{
+    return fxColormap({{0.000, wxColour(0x44, 0x01, 0x54)},
+                       {0.125, wxColour(0x47, 0x2d, 0x7b)},
+                       {0.250, wxColour(0x3b, 0x52, 0x8b)},
+                       {0.375, wxColour(0x2c, 0x72, 0x8e)},
+                       {0.500, wxColour(0x21, 0x91, 0x8c)},
+                       {0.625, wxColour(0x28, 0xae, 0x80)},
+                       {0.750, wxColour(0x5e, 0xc9, 0x62)},
+                       {0.875, wxColour(0xad, 0xdc, 0x30)},
+                       {1.000, wxColour(0xfd, 0xe7, 0x25)}});
+}
+
+fxColormap fxColormap::Jet()
+{
+    return fxColormap({{0.000, wxColour(0, 0, 128)},
+                       {0.110, wxColour(0, 0, 255)},
+                       {0.340, wxColour(0, 255, 255)},
+                       {0.650, wxColour(255, 255, 0)},
+                       {0.890, wxColour(255, 0, 0)},
+                       {1.000, wxColour(128, 0, 0)}});
+}
+
+fxColormap fxColormap::CoolWarm()
+{
+    return fxColormap({{0.00, wxColour(59, 76, 192)},
+                       {0.25, wxColour(141, 176, 254)},
+                       {0.50, wxColour(221, 221, 221)},
+                       {0.75, wxColour(244, 154, 123)},
+                       {1.00, wxColour(180, 4, 38)}});
+}
+
+fxColormap fxColormap::Grey()
+{
+    return fxColormap({{0.0, wxColour(0, 0, 0)}, {1.0, wxColour(255, 255, 255)}});
+}
+
+bool fxColormap::FromName(const wxString& name, fxColormap& colormap)
+{
+    const wxString key = name.Lower();
+    if (key == "viridis")                              colormap = Viridis();
+    else if (key == "jet")                             colormap = Jet();
+    else if (key == "coolwarm" || key == "diverging")  colormap = CoolWarm();
+    else if (key == "grey" || key == "gray")           colormap = Grey();
+    else return false;
+    return true;
+}
+
+//--------------------------------------
+// Settings
+//--------------------------------------
+void fxColormap::SetTableSize(size_t size)
+{
+    size = std::max<size_t>(2, size);
+    if (size == m_size) return;
+    m_size = size;
+    BuildTable();
+}
+
+void fxColormap::SetRange(double min, double max)
+{
+    m_min = min;
+    m_max = max;
+}
+
+void fxColormap::SetScale(fxColormapScale scale)
+{
+    m_scale = scale;
+}
+
+void fxColormap::SetNaNColour(const wxColour& colour)
+{
+    m_nanColour = colour;
+    UpdateSpecialEntries();
+}
+
+void fxColormap::SetUnderColour(const wxColour& colour)
+{
+    m_underColour = colour;
+    UpdateSpecialEntries();
+}
+
+void fxColormap::SetOverColour(const wxColour& colour)
+{
+    m_overColour = colour;
+    UpdateSpecialEntries();
+}
+
+void fxColormap::ResetUnderOverColours()
+{
+    m_underColour = wxColour();
+    m_overColour = wxColour();
+    UpdateSpecialEntries();
+}
+
+//--------------------------------------
+// Table
+//--------------------------------------
+void fxColormap::BuildTable()
+{
+    m_table.assign(m_size + 3, 0u);
+
+    size_t s = 0;
+    for (size_t i = 0; i < m_size && !m_stops.empty(); ++i) {
+        // Entry i stands for the middle of its bin
+        const double t = (i + 0.5) / m_size;
+        while (s + 1 < m_stops.size() && m_stops[s + 1].position <= t) ++s;
+
+        const fxColormapStop& a = m_stops[s];
+        if (s + 1 == m_stops.size() || t <= a.position) {
+            m_table[i] = Pack(a.colour);
+            continue;
+        }
+        const fxColormapStop& b = m_stops[s + 1];
+        const double u = (t - a.position) / (b.position - a.position);
+        m_table[i] = Pack(wxColour(Lerp(a.colour.Red(), b.colour.Red(), u),
+                                   Lerp(a.colour.Green(), b.colour.Green(), u),
+                                   Lerp(a.colour.Blue(), b.colour.Blue(), u),
+                                   Lerp(a.colour.Alpha(), b.colour.Alpha(), u)));
+    }
+    UpdateSpecialEntries();
+}
+
+void fxColormap::UpdateSpecialEntries()
+{
+    m_table[m_size]     = Pack(m_nanColour);
+    m_table[m_size + 1] = m_underColour.IsOk() ? Pack(m_underColour) : m_table[0];
+    m_table[m_size + 2] = m_overColour.IsOk() ? Pack(m_overColour) : m_table[m_size - 1];
+}
+
+//--------------------------------------
+// Mapping
+//--------------------------------------
+template <typename T>
+void fxColormap::Indices(const T* values, size_t n, int32_t* index) const
+{
+    const int32_t nanIndex   = static_cast<int32_t>(m_size);
+    const int32_t underIndex = nanIndex + 1;
+    const int32_t overIndex  = nanIndex + 2;
+    const double  top = double(m_size - 1);
+
+    if (m_scale == fxColormapScale::Log) {
+        // No vector log in AVX2: scalar
+        const double lo = std::log(m_min);
+        const double span = std::log(m_max) - lo;
+        // Without a positive range there is nothing to map onto
+        const bool valid = m_min > 0.0 && m_max > m_min && std::isfinite(span);
+        const double scale = valid ? m_size / span : 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const double v = values[i];
+            if (std::isnan(v))                         index[i] = nanIndex;
+            else if (!valid || v < m_min || v <= 0.0)  index[i] = underIndex;
+            else if (v > m_max)                        index[i] = overIndex;
+            else index[i] = ClampIndex((std::log(v) - lo) * scale, top);
+        }
+        return;
+    }
+
+    const double span = m_max - m_min;
+    const double scale = span > 0.0 ? m_size / span : 0.0;
+    size_t i = 0;
+
+#if FX_SIMD_AVX2
+    if (fxHasAVX2()) {
+        i = LinearIndicesAVX2(values, n, m_min, m_max, scale, top, nanIndex, underIndex, overIndex, index);
+    }
+#endif
+
+    for (; i < n; ++i) {
+        const double v = values[i];
+        if (std::isnan(v))      index[i] = nanIndex;
+        else if (v < m_min)     index[i] = underIndex;
+        else if (v > m_max)     index[i] = overIndex;
+        else index[i] = ClampIndex((v - m_min) * scale, top);
+    }
+}
+
+template <typename T>
+void fxColormap::MapRGBAImpl(const T* values, size_t n, uint32_t* rgba) const
+{
+    int32_t index[CHUNK];
+    const uint32_t* table = m_table.data();
+#if FX_SIMD_AVX2
+    const bool avx2 = fxHasAVX2();
+#endif
+
+    for (size_t start = 0; start < n; start += CHUNK) {
+        const size_t count = std::min(CHUNK, n - start);
+        Indices(values + start, count, index);
+        uint32_t* out = rgba + start;
+
+        size_t i = 0;
+#if FX_SIMD_AVX2
+        if (avx2) i = GatherAVX2(table, index, count, out);
+#endif
+        for (; i < count; ++i) out[i] = table[index[i]];
+    }
+}
+
+template <typename T>
+void fxColormap::MapImpl(const T* values, size_t n, unsigned char* rgb, unsigned char* alpha) const
+{
+    int32_t index[CHUNK];
+
+    for (size_t start = 0; start < n; start += CHUNK) {
+        const size_t count = std::min(CHUNK, n - start);
+        Indices(values + start, count, index);
+        for (size_t i = 0; i < count; ++i) {
+            Store(m_table[index[i]], rgb + 3 * (start + i), alpha ? alpha + start + i : nullptr);
+        }
+    }
+}
+
+uint32_t fxColormap::GetRGBA(double value) const
+{
+    int32_t index;
+    Indices(&value, 1, &index);
+    return m_table[index];
+}
+
+wxColour fxColormap::GetColour(double value) const
+{
+    const uint32_t c = GetRGBA(value);
+    return wxColour(c & 0xff, (c >> 8) & 0xff, (c >> 16) & 0xff, c >> 24);
+}
+
+void fxColormap::MapRGBA(const double* values, size_t n, uint32_t* rgba) const
+{
+    MapRGBAImpl(values, n, rgba);
+}
+
+void fxColormap::MapRGBA(const float* values, size_t n, uint32_t* rgba) const
+{
+    MapRGBAImpl(values, n, rgba);
+}
+
+void fxColormap::Map(const double* values, size_t n, unsigned char* rgb, unsigned char* alpha) const
+{
+    MapImpl(values, n, rgb, alpha);
+}
+
+void fxColormap::Map(const float* values, size_t n, unsigned char* rgb, unsigned char* alpha) const
+{
+    MapImpl(values, n, rgb, alpha);
+}
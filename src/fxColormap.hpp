@@ -0,0 +1,114 @@
+// fxColormap.hpp
+
+#ifndef FXCOLORMAP_HPP
+#define FXCOLORMAP_HPP
+
+#include <cstdint>
+#include <vector>
+#include <wx/colour.h>
+#include <wx/string.h>
+
+// Colour stop of a colormap, position in [0, 1]
+struct fxColormapStop
+{
+    double   position;
+    wxColour colour;
+};
+
+// How values are brought to [0, 1] before the lookup
+enum class fxColormapScale
+{
+    Linear = 0,
+    Log         // log(value) between log(min) and log(max); values <= 0 are under the range,
+                // and so is everything unless 0 < min < max
+};
+
+// Maps scalar values to colours through a lookup table.
+//
+// The stops are sampled once into a table of GetTableSize() entries spanning
+// [min, max] (256 by default, 4096 for smooth gradients over wide ranges).
+// Values below or above the range take the under/over colours, which default
+// to the end colours; NaN takes the NaN colour, transparent by default.
+// Mapping a run of values costs one normalization and one table read per
+// value; the linear scale is vectorized with AVX2 on CPUs that have it.
+//
+// Packed RGBA is r | g << 8 | b << 16 | a << 24, i.e. bytes R, G, B, A in
+// memory on little-endian machines.
+class fxColormap
+{
+public:
+    static const size_t DEFAULT_TABLE_SIZE = 256;
+    static const size_t LARGE_TABLE_SIZE   = 4096;
+
+    // Viridis
+    fxColormap();
+    explicit fxColormap(const std::vector<fxColormapStop>& stops, size_t tableSize = DEFAULT_TABLE_SIZE);
+
+    // Named maps
+    static fxColormap Viridis();
+    static fxColormap Jet();
+    static fxColormap CoolWarm();  // diverging blue - grey - red
+    static fxColormap Grey();
+
+    // "viridis", "jet", "coolwarm" (or "diverging"), "grey" (or "gray"); case-insensitive
+    static bool FromName(const wxString& name, fxColormap& colormap);
+
+    const std::vector<fxColormapStop>& GetStops() const { return m_stops; }
+
+    // Table entries between min and max (at least 2)
+    void SetTableSize(size_t size);
+    size_t GetTableSize() const { return m_size; }
+
+    // Normalization
+    void SetRange(double min, double max);
+    double GetMin() const { return m_min; }
+    double GetMax() const { return m_max; }
+
+    void SetScale(fxColormapScale scale);
+    fxColormapScale GetScale() const { return m_scale; }
+
+    // Special colours
+    void SetNaNColour(const wxColour& colour);
+    const wxColour& GetNaNColour() const { return m_nanColour; }
+
+    void SetUnderColour(const wxColour& colour);
+    void SetOverColour(const wxColour& colour);
+    // Back to the end colours of the map
+    void ResetUnderOverColours();
+
+    // Single value, e.g. the brush of a contour band or a marker
+    wxColour GetColour(double value) const;
+    uint32_t GetRGBA(double value) const;
+
+    // Colour n values as packed RGBA
+    void MapRGBA(const double* values, size_t n, uint32_t* rgba) const;
+    void MapRGBA(const float* values, size_t n, uint32_t* rgba) const;
+
+    // Colour n values into wxImage layout: 3 bytes per value in rgb and,
+    // if given, one byte per value in alpha
+    void Map(const double* values, size_t n, unsigned char* rgb, unsigned char* alpha = nullptr) const;
+    void Map(const float* values, size_t n, unsigned char* rgb, unsigned char* alpha = nullptr) const;
+
+private:
+    std::vector<fxColormapStop> m_stops;
+    size_t          m_size = DEFAULT_TABLE_SIZE;
+    double          m_min = 0.0;
+    double          m_max = 1.0;
+    fxColormapScale m_scale = fxColormapScale::Linear;
+
+    wxColour m_nanColour = wxColour(0, 0, 0, 0);
+    wxColour m_underColour;     // not Ok: first table entry
+    wxColour m_overColour;      // not Ok: last table entry
+
+    // m_size entries, then NaN, under and over
+    std::vector<uint32_t> m_table;
+
+    void BuildTable();
+    void UpdateSpecialEntries();
+
+    template <typename T> void Indices(const T* values, size_t n, int32_t* index) const;
+    template <typename T> void MapRGBAImpl(const T* values, size_t n, uint32_t* rgba) const;
+    template <typename T> void MapImpl(const T* values, size_t n, unsigned char* rgb, unsigned char* alpha) const;
+};
+
+#endif // FXCOLORMAP_HPP
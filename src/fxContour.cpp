@@ -0,0 +1,371 @@
+// fxContour.cpp
+#include "fxContour.hpp"
+#include "fxParallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace {
+
+const double MINUS_INF = -std::numeric_limits<double>::infinity();
+
+// The grid seen with one ring of -inf around it (padded coordinates pr, pc:
+// the real sample (r, c) sits at (r + 1, c + 1)). NaN reads as -inf.
+struct PaddedGrid
+{
+    const double* values;
+    size_t rows, cols;     // real grid
+    size_t prows, pcols;   // padded grid
+    std::vector<double> px, py;  // axes, the padding repeating the border
+
+    explicit PaddedGrid(const fxGridData& grid)
+        : values(grid.GetValues()), rows(grid.GetRows()), cols(grid.GetCols()),
+          prows(rows + 2), pcols(cols + 2), px(pcols), py(prows)
+    {
+        const double* x = grid.GetColumnAxis();
+        const double* y = grid.GetRowAxis();
+        std::copy(x, x + cols, px.begin() + 1);
+        std::copy(y, y + rows, py.begin() + 1);
+        px.front() = x[0]; px.back() = x[cols - 1];
+        py.front() = y[0]; py.back() = y[rows - 1];
+    }
+
+    // Padded row pr, sanitized, into out[pcols]
+    void FillRow(size_t pr, double* out) const
+    {
+        out[0] = out[pcols - 1] = MINUS_INF;
+        if (pr - 1 >= rows) {  // unsigned wrap covers pr == 0
+            std::fill(out + 1, out + pcols - 1, MINUS_INF);
+            return;
+        }
+        const double* src = values + (pr - 1) * cols;
+        for (size_t c = 0; c < cols; ++c) {
+            out[c + 1] = std::isnan(src[c]) ? MINUS_INF : src[c];
+        }
+    }
+
+    // Edge keys: horizontal edge (pr, pc)-(pr, pc+1) and vertical edge (pr, pc)-(pr+1, pc)
+    uint64_t HKey(size_t pr, size_t pc) const { return 2 * (uint64_t(pr) * pcols + pc); }
+    uint64_t VKey(size_t pr, size_t pc) const { return 2 * (uint64_t(pr) * pcols + pc) + 1; }
+
+    // Data coordinates of the level crossing between two corners. Out-of-grid
+    // corners are -inf, which pins the crossing to the sample inside the grid.
+    wxPoint2DDouble Crossing(size_t pr1, size_t pc1, double v1, size_t pr2, size_t pc2, double v2, double level) const
+    {
+        double t;
+        if (v1 == MINUS_INF)      t = 1.0;
+        else if (v2 == MINUS_INF) t = 0.0;
+        else                      t = (level - v1) / (v2 - v1);
+        return wxPoint2DDouble(px[pc1] + t * (px[pc2] - px[pc1]), py[pr1] + t * (py[pr2] - py[pr1]));
+    }
+};
+
+// A cell's piece of contour, between two edges. The crossing points are
+// computed while the cell values are at hand: looking them up again at
+// stitching time would be a cache miss per point on large grids.
+struct Segment
+{
+    uint64_t from;
+    uint64_t to;
+    wxPoint2DDouble toPoint;
+    wxPoint2DDouble fromPoint;
+};
+
+// Number of sorted levels <= v, walking from the previous bucket
+// (neighbouring samples are usually close)
+inline uint32_t Bucket(double v, const std::vector<double>& levels, uint32_t b)
+{
+    const uint32_t n = static_cast<uint32_t>(levels.size());
+    while (b < n && v >= levels[b]) ++b;
+    while (b > 0 && v < levels[b - 1]) --b;
+    return b;
+}
+
+// Marching squares over padded cell rows [prBegin, prEnd), all levels in one pass.
+// Each sample is reduced to its bucket among the sorted levels: a cell crosses
+// level i only if its corner buckets straddle i, so most cells cost one
+// min/max test whatever the number of levels.
+//
+// Cell corners clockwise: 0 = (pr, pc), 1 = (pr, pc+1), 2 = (pr+1, pc+1), 3 = (pr+1, pc);
+// edge i joins corner i to corner i+1. Walking clockwise, a segment starts
+// where the walk enters the inside region and ends where it leaves it.
+void MarchRows(const PaddedGrid& g, const std::vector<double>& levels, size_t prBegin, size_t prEnd,
+               size_t pcBegin, size_t pcEnd, std::vector<std::vector<Segment>>& out)
+{
+    std::vector<double> upper(g.pcols), lower(g.pcols);
+    std::vector<uint32_t> upperBucket(g.pcols), lowerBucket(g.pcols);
+
+    auto fill = [&](size_t pr, std::vector<double>& row, std::vector<uint32_t>& buckets) {
+        g.FillRow(pr, row.data());
+        uint32_t b = 0;
+        for (size_t pc = 0; pc < g.pcols; ++pc) buckets[pc] = b = Bucket(row[pc], levels, b);
+    };
+    fill(prBegin, lower, lowerBucket);
+
+    for (size_t pr = prBegin; pr < prEnd; ++pr)
+    {
+        upper.swap(lower);
+        upperBucket.swap(lowerBucket);
+        fill(pr + 1, lower, lowerBucket);
+
+        for (size_t pc = pcBegin; pc < pcEnd; ++pc)
+        {
+            const uint32_t b[4] = {upperBucket[pc], upperBucket[pc + 1], lowerBucket[pc + 1], lowerBucket[pc]};
+            const uint32_t lo = std::min(std::min(b[0], b[1]), std::min(b[2], b[3]));
+            const uint32_t hi = std::max(std::max(b[0], b[1]), std::max(b[2], b[3]));
+            if (lo == hi) continue;
+
+            const double v[4] = {upper[pc], upper[pc + 1], lower[pc + 1], lower[pc]};
+            const uint64_t edges[4] = {g.HKey(pr, pc), g.VKey(pr, pc + 1), g.HKey(pr + 1, pc), g.VKey(pr, pc)};
+            const size_t cr[4] = {pr, pr, pr + 1, pr + 1};
+            const size_t cc[4] = {pc, pc + 1, pc + 1, pc};
+
+            for (uint32_t l = lo; l < hi; ++l)
+            {
+                const double level = levels[l];
+                const int index = (b[0] > l) | (b[1] > l) << 1 | (b[2] > l) << 2 | (b[3] > l) << 3;
+
+                auto crossing = [&](int edge) {
+                    const int p = edge, q = (edge + 1) & 3;
+                    return g.Crossing(cr[p], cc[p], v[p], cr[q], cc[q], v[q], level);
+                };
+                const bool saddle = (index == 5 || index == 10);
+                const bool centerInside = saddle && 0.25 * (v[0] + v[1] + v[2] + v[3]) >= level;
+
+                for (int e = 0; e < 4; ++e)
+                {
+                    // Entering: corner e outside, corner e+1 inside
+                    const bool in0 = (index >> e) & 1, in1 = (index >> ((e + 1) & 3)) & 1;
+                    if (in0 || !in1) continue;
+
+                    int exit;
+                    if (centerInside) {
+                        exit = (e + 3) & 3;   // cut off the outside corner
+                    } else {
+                        exit = (e + 1) & 3;   // next crossing clockwise
+                        while (!(((index >> exit) & 1) && !((index >> ((exit + 1) & 3)) & 1))) exit = (exit + 1) & 3;
+                    }
+                    out[l].push_back({edges[e], edges[exit], crossing(exit), crossing(e)});
+                }
+            }
+        }
+    }
+}
+
+// Segments of one band of cell rows, by level
+std::vector<std::vector<Segment>> MarchBand(const PaddedGrid& g, const std::vector<double>& levels,
+                                            const fxContourOptions& options, size_t band, size_t bandRows)
+{
+    // Cells between padded rows/cols; the outer ring only when closing
+    const size_t first = options.closeAtBorder ? 0 : 1;
+    const size_t lastRow = options.closeAtBorder ? g.prows - 1 : g.prows - 2;
+    const size_t lastCol = options.closeAtBorder ? g.pcols - 1 : g.pcols - 2;
+
+    std::vector<std::vector<Segment>> segments(levels.size());
+    const size_t begin = first + band * bandRows;
+    const size_t end = std::min(lastRow, begin + bandRows);
+    if (begin < end) MarchRows(g, levels, begin, end, first, lastCol, segments);
+    return segments;
+}
+
+size_t CountBands(const PaddedGrid& g, const fxContourOptions& options, size_t bandRows)
+{
+    const size_t cellRows = options.closeAtBorder ? g.prows - 1 : g.prows - 3;
+    return (cellRows + bandRows - 1) / bandRows;
+}
+
+// Join segments sharing edges: open lines first (from border entries), then loops
+std::vector<fxContourLine> Stitch(const std::vector<Segment>& segments)
+{
+    std::vector<fxContourLine> lines;
+    const size_t n = segments.size();
+    if (n == 0) return lines;
+
+    // Segment index by start edge: open addressing, load factor <= 1/2
+    const uint32_t NONE = std::numeric_limits<uint32_t>::max();
+    int bits = 1;
+    while ((size_t(1) << bits) < 2 * n) ++bits;
+    const size_t mask = (size_t(1) << bits) - 1;
+    std::vector<uint32_t> table(mask + 1, NONE);
+
+    auto slot = [&](uint64_t edge) {
+        return static_cast<size_t>((edge * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+    };
+    for (uint32_t i = 0; i < n; ++i) {
+        size_t s = slot(segments[i].from);
+        while (table[s] != NONE) s = (s + 1) & mask;
+        table[s] = i;
+    }
+    auto successor = [&](uint64_t edge) {
+        for (size_t s = slot(edge); table[s] != NONE; s = (s + 1) & mask) {
+            if (segments[table[s]].from == edge) return table[s];
+        }
+        return NONE;
+    };
+
+    std::vector<uint32_t> next(n);
+    std::vector<char> hasPredecessor(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        next[i] = successor(segments[i].to);
+        if (next[i] != NONE) hasPredecessor[next[i]] = 1;
+    }
+
+    std::vector<char> used(n, 0);
+    auto follow = [&](uint32_t start, bool closed) {
+        fxContourLine line;
+        line.closed = closed;
+        line.points.push_back(segments[start].fromPoint);
+        for (uint32_t i = start; i != NONE && !used[i]; i = next[i]) {
+            used[i] = 1;
+            const wxPoint2DDouble& p = segments[i].toPoint;
+            if (p != line.points.back()) line.points.push_back(p);
+        }
+        // A loop ends on its first point
+        if (closed && line.points.size() > 1 && line.points.back() == line.points.front()) {
+            line.points.pop_back();
+        }
+        if (line.points.size() > 1) lines.push_back(std::move(line));
+    };
+
+    for (uint32_t i = 0; i < n; ++i) {
+        if (!hasPredecessor[i]) follow(i, false);
+    }
+    for (uint32_t i = 0; i < n; ++i) {
+        if (!used[i]) follow(i, true);
+    }
+    return lines;
+}
+
+} // namespace
+
+//--------------------------------------
+// Tracing
+//--------------------------------------
+std::vector<std::vector<fxContourLine>> TraceContourLines(const fxGridData& grid, const std::vector<double>& levels,
+                                                          const fxContourOptions& options)
+{
+    std::vector<std::vector<fxContourLine>> result(levels.size());
+    if (grid.GetRows() < 2 || grid.GetCols() < 2 || levels.empty()) return result;
+
+    // Distinct levels in increasing order (NaN levels match nothing)
+    std::vector<double> sorted;
+    for (double level : levels) {
+        if (!std::isnan(level)) sorted.push_back(level);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    if (sorted.empty()) return result;
+
+    const PaddedGrid g(grid);
+    const size_t bandRows = std::max<size_t>(1, options.bandRows);
+    const size_t bands = CountBands(g, options, bandRows);
+
+    // Segments of every band, then one stitch per level
+    std::vector<std::vector<std::vector<Segment>>> parts(bands);
+    fxParallelForEach(bands, [&](size_t band) {
+        parts[band] = MarchBand(g, sorted, options, band, bandRows);
+    });
+
+    std::vector<std::vector<fxContourLine>> lines(sorted.size());
+    fxParallelForEach(sorted.size(), [&](size_t l) {
+        size_t total = 0;
+        for (size_t b = 0; b < bands; ++b) total += parts[b][l].size();
+
+        std::vector<Segment> segments;
+        segments.reserve(total);
+        for (size_t b = 0; b < bands; ++b) {
+            auto& part = parts[b][l];
+            segments.insert(segments.end(), part.begin(), part.end());
+            std::vector<Segment>().swap(part);
+        }
+        lines[l] = Stitch(segments);
+    });
+
+    // Back to the caller's order; repeated levels get copies
+    std::vector<char> moved(sorted.size(), 0);
+    for (size_t i = 0; i < levels.size(); ++i) {
+        auto it = std::lower_bound(sorted.begin(), sorted.end(), levels[i]);
+        if (it == sorted.end() || *it != levels[i]) continue;
+
+        const size_t l = it - sorted.begin();
+        if (moved[l]) {
+            result[i] = result[std::find(levels.begin(), levels.end(), levels[i]) - levels.begin()];
+        } else {
+            result[i] = std::move(lines[l]);
+            moved[l] = 1;
+        }
+    }
+    return result;
+}
+
+std::vector<fxContourLine> TraceContourLines(const fxGridData& grid, double level, const fxContourOptions& options)
+{
+    return std::move(TraceContourLines(grid, std::vector<double>{level}, options).front());
+}
+
+//--------------------------------------
+// Paths
+//--------------------------------------
+void AddContourLines(fxGraphicsPath& path, const std::vector<fxContourLine>& lines, bool smooth)
+{
+    for (const auto& line : lines)
+    {
+        const auto& p = line.points;
+        const size_t n = p.size();
+        if (n < 2) continue;
+
+        path.MoveToPoint(p[0]);
+
+        if (!smooth || n < 3) {
+            for (size_t i = 1; i < n; ++i) path.AddLineToPoint(p[i]);
+        } else {
+            // Catmull-Rom spline as cubic Beziers; ends are clamped on open lines
+            auto at = [&](ptrdiff_t i) -> const wxPoint2DDouble& {
+                if (line.closed) return p[(i % ptrdiff_t(n) + n) % n];
+                return p[std::min<ptrdiff_t>(std::max<ptrdiff_t>(i, 0), n - 1)];
+            };
+            const size_t count = line.closed ? n : n - 1;
+            for (size_t i = 0; i < count; ++i) {
+                const wxPoint2DDouble& p0 = at(ptrdiff_t(i) - 1);
+                const wxPoint2DDouble& p1 = at(i);
+                const wxPoint2DDouble& p2 = at(i + 1);
+                const wxPoint2DDouble& p3 = at(i + 2);
+                path.AddCurveToPoint(p1.m_x + (p2.m_x - p0.m_x) / 6.0, p1.m_y + (p2.m_y - p0.m_y) / 6.0,
+                                     p2.m_x - (p3.m_x - p1.m_x) / 6.0, p2.m_y - (p3.m_y - p1.m_y) / 6.0,
+                                     p2.m_x, p2.m_y);
+            }
+        }
+
+        if (line.closed) path.CloseSubpath();
+    }
+}
+
+std::vector<fxGraphicsPath> ComputeContours(const fxGridData& grid, const std::vector<double>& levels,
+                                            const fxContourOptions& options)
+{
+    const auto lines = TraceContourLines(grid, levels, options);
+
+    std::vector<fxGraphicsPath> paths(levels.size());
+    fxParallelForEach(levels.size(), [&](size_t l) {
+        AddContourLines(paths[l], lines[l], options.smooth);
+    });
+    return paths;
+}
+
+std::vector<fxGraphicsPath> ComputeContourBands(const fxGridData& grid, const std::vector<double>& levels,
+                                                const fxContourOptions& options)
+{
+    if (levels.size() < 2) return {};
+
+    fxContourOptions ringOptions = options;
+    ringOptions.closeAtBorder = true;
+    const auto rings = TraceContourLines(grid, levels, ringOptions);
+
+    std::vector<fxGraphicsPath> bands(levels.size() - 1);
+    fxParallelForEach(bands.size(), [&](size_t b) {
+        AddContourLines(bands[b], rings[b], options.smooth);
+        AddContourLines(bands[b], rings[b + 1], options.smooth);
+    });
+    return bands;
+}
@@ -0,0 +1,64 @@
+// fxContour.hpp
+
+#ifndef FXCONTOUR_HPP
+#define FXCONTOUR_HPP
+
+#include <vector>
+#include <wx/geometry.h>
+#include "fxGraphicsPath.hpp"
+#include "fxGridData.hpp"
+
+// Marching-squares contouring of fxGridData.
+//
+// Cells are classified with value >= level as inside; NaN counts as below
+// every level. Saddle cells are resolved with the average of the four corners.
+// Cell segments are oriented so that every grid edge starts one segment and
+// ends another, which lets the stitcher join them into polylines in one pass.
+// Output coordinates are data coordinates: x from the column axis, y from the
+// row axis (transform the paths to place them on screen).
+
+struct fxContourOptions
+{
+    // Replace the polylines by Catmull-Rom cubic segments through their vertices
+    bool smooth = false;
+
+    // Treat everything outside the grid as -infinity: every line becomes a
+    // ring around the region >= level, running along the grid border where
+    // needed (the basis of filled contours)
+    bool closeAtBorder = false;
+
+    // Grid rows per parallel task
+    size_t bandRows = 64;
+};
+
+struct fxContourLine
+{
+    std::vector<wxPoint2DDouble> points;
+    bool closed = false;
+};
+
+// Stitched polylines of one level
+std::vector<fxContourLine> TraceContourLines(const fxGridData& grid, double level,
+                                             const fxContourOptions& options = fxContourOptions());
+
+// Polylines of several levels; rows and levels are processed in parallel
+std::vector<std::vector<fxContourLine>> TraceContourLines(const fxGridData& grid, const std::vector<double>& levels,
+                                                          const fxContourOptions& options = fxContourOptions());
+
+// One geometry-only path per level (open lines and closed subpaths)
+std::vector<fxGraphicsPath> ComputeContours(const fxGridData& grid, const std::vector<double>& levels,
+                                            const fxContourOptions& options = fxContourOptions());
+
+// Filled bands between consecutive levels: path i covers
+// levels[i] <= value < levels[i+1] and is meant for FillPath with
+// wxODDEVEN_RULE. Each band is the even-odd union of the border-closed rings
+// of its two levels, so islands and holes come out right; the rings of the
+// row bands processed in parallel are stitched across the seams by edge key.
+// options.closeAtBorder is implied.
+std::vector<fxGraphicsPath> ComputeContourBands(const fxGridData& grid, const std::vector<double>& levels,
+                                                const fxContourOptions& options = fxContourOptions());
+
+// Append polylines to a path, as straight or smoothed segments
+void AddContourLines(fxGraphicsPath& path, const std::vector<fxContourLine>& lines, bool smooth = false);
+
+#endif // FXCONTOUR_HPP
@@ -0,0 +1,232 @@
+// fxDensity.cpp
+#include "fxDensity.hpp"
+#include "fxParallel.hpp"
+#include "fxTrace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Points binned per task at least (below that, threads cost more than they save)
+const size_t MIN_POINTS_PER_TASK = 1 << 20;
+
+// Memory allowed for the per-thread grids
+const size_t MAX_PARTIAL_BYTES = 256 * 1024 * 1024;
+
+// Pixels summed or shaded per task at least
+const size_t MIN_PIXELS_PER_TASK = 1 << 16;
+
+// Largest count handled with a counting histogram by the equalization
+const uint32_t MAX_HISTOGRAM_COUNT = 1 << 24;
+
+// Bin points [begin, end) into counts (and sums); returns the number inside
+template <bool WithValues, typename PointAt>
+uint64_t BinRange(size_t begin, size_t end, PointAt pointAt, const double* values,
+                  const wxRect2DDouble& rect, size_t width, size_t height, uint32_t* counts, double* sums)
+{
+    const double sx = width / rect.m_width;
+    const double sy = height / rect.m_height;
+    const double left = rect.m_x;
+    const double top = rect.m_y + rect.m_height;
+    const double fw = double(width), fh = double(height);
+
+    uint64_t inside = 0;
+    for (size_t i = begin; i < end; ++i) {
+        double x, y;
+        pointAt(i, x, y);
+        const double fx = (x - left) * sx;
+        const double fy = (top - y) * sy;
+        // Also rejects NaN
+        if (!(fx >= 0.0 && fx < fw && fy >= 0.0 && fy < fh)) continue;
+
+        const size_t k = size_t(fy) * width + size_t(fx);
+        ++counts[k];
+        if (WithValues) sums[k] += values[i];
+        ++inside;
+    }
+    return inside;
+}
+
+} // namespace
+
+//--------------------------------------
+// Aggregation
+//--------------------------------------
+void fxDensityRenderer::Aggregate(const double* x, const double* y, size_t n, const wxSize& size,
+                                  const double* values)
+{
+    AggregateImpl(n, size, values, [x, y](size_t i, double& px, double& py) { px = x[i]; py = y[i]; });
+}
+
+void fxDensityRenderer::Aggregate(const wxPoint2DDouble* points, size_t n, const wxSize& size)
+{
+    AggregateImpl(n, size, nullptr,
+                  [points](size_t i, double& px, double& py) { px = points[i].m_x; py = points[i].m_y; });
+}
+
+template <typename PointAt>
+void fxDensityRenderer::AggregateImpl(size_t n, const wxSize& size, const double* values, PointAt pointAt)
+{
+    FX_TRACE_SCOPE(Encode, "DensityAggregate");
+
+    const size_t width  = std::max(0, size.GetWidth());
+    const size_t height = std::max(0, size.GetHeight());
+    const size_t pixels = width * height;
+
+    m_size = size;
+    m_binned = 0;
+    m_counts.assign(pixels, 0);
+    if (values) m_sums.assign(pixels, 0.0);
+    else m_sums.clear();
+    if (pixels == 0 || n == 0 || !(m_dataRect.m_width > 0.0) || !(m_dataRect.m_height > 0.0)) return;
+
+    const size_t pixelBytes = sizeof(uint32_t) + (values ? sizeof(double) : 0);
+    const size_t maxTasks = 1 + MAX_PARTIAL_BYTES / (pixels * pixelBytes);
+    const size_t tasks = std::min(maxTasks, fxParallelThreads(n / MIN_POINTS_PER_TASK));
+    const size_t step = (n + tasks - 1) / tasks;
+
+    m_partialCounts.resize(tasks - 1);
+    m_partialSums.resize(values ? tasks - 1 : 0);
+    std::vector<uint64_t> inside(tasks, 0);
+
+    fxParallelForEach(tasks, [&](size_t t) {
+        // Task 0 bins straight into the result
+        uint32_t* counts = m_counts.data();
+        double* sums = values ? m_sums.data() : nullptr;
+        if (t > 0) {
+            m_partialCounts[t - 1].assign(pixels, 0);
+            counts = m_partialCounts[t - 1].data();
+            if (values) {
+                m_partialSums[t - 1].assign(pixels, 0.0);
+                sums = m_partialSums[t - 1].data();
+            }
+        }
+
+        const size_t begin = t * step;
+        const size_t end = std::min(n, begin + step);
+        if (begin >= end) return;
+        inside[t] = values ? BinRange<true>(begin, end, pointAt, values, m_dataRect, width, height, counts, sums)
+                           : BinRange<false>(begin, end, pointAt, values, m_dataRect, width, height, counts, sums);
+    });
+
+    // Reduction, split by pixels
+    if (tasks > 1) {
+        fxParallelFor(pixels, MIN_PIXELS_PER_TASK, [&](size_t begin, size_t end) {
+            for (const auto& partial : m_partialCounts) {
+                for (size_t k = begin; k < end; ++k) m_counts[k] += partial[k];
+            }
+            for (const auto& partial : m_partialSums) {
+                for (size_t k = begin; k < end; ++k) m_sums[k] += partial[k];
+            }
+        });
+    }
+
+    for (uint64_t count : inside) m_binned += count;
+}
+
+//--------------------------------------
+// Shading
+//--------------------------------------
+wxImage fxDensityRenderer::Shade(const fxColormap& colormap) const
+{
+    const size_t pixels = m_counts.size();
+    if (pixels == 0) return wxImage();
+
+    FX_TRACE_SCOPE(Encode, "DensityShade");
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const bool mean = HasValues();
+
+    // Pixel quantity, NaN when empty
+    std::vector<double> q(pixels);
+    fxParallelFor(pixels, MIN_PIXELS_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            const uint32_t c = m_counts[k];
+            q[k] = c == 0 ? nan : mean ? m_sums[k] / c : double(c);
+        }
+    });
+
+    // Transfer to [0, 1]
+    switch (m_transfer) {
+    case fxDensityTransfer::Linear:
+    case fxDensityTransfer::Log: {
+        const bool log = m_transfer == fxDensityTransfer::Log;
+        double lo = std::numeric_limits<double>::infinity(), hi = -lo;
+        for (double v : q) {
+            if (std::isnan(v) || (log && v <= 0.0)) continue;
+            const double u = log ? std::log(v) : v;
+            lo = std::min(lo, u);
+            hi = std::max(hi, u);
+        }
+        const double scale = hi > lo ? 1.0 / (hi - lo) : 0.0;
+        const double flat = hi > lo ? 0.0 : 1.0;   // a single value takes the top colour
+        fxParallelFor(pixels, MIN_PIXELS_PER_TASK, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const double v = q[k];
+                if (std::isnan(v)) continue;
+                if (log && v <= 0.0) { q[k] = 0.0; continue; }
+                q[k] = ((log ? std::log(v) : v) - lo) * scale + flat;
+            }
+        });
+        break;
+    }
+    case fxDensityTransfer::EqualizeHistogram: {
+        // Fraction of the non-empty pixels at or below the value
+        const uint32_t maxCount = *std::max_element(m_counts.begin(), m_counts.end());
+        if (!mean && maxCount <= MAX_HISTOGRAM_COUNT) {
+            std::vector<uint64_t> cdf(size_t(maxCount) + 1, 0);
+            for (uint32_t c : m_counts) ++cdf[c];
+            cdf[0] = 0;
+            for (size_t c = 1; c < cdf.size(); ++c) cdf[c] += cdf[c - 1];
+            const double total = double(cdf.back());
+            fxParallelFor(pixels, MIN_PIXELS_PER_TASK, [&](size_t begin, size_t end) {
+                for (size_t k = begin; k < end; ++k) {
+                    if (m_counts[k] != 0) q[k] = cdf[m_counts[k]] / total;
+                }
+            });
+        } else {
+            std::vector<double> sorted;
+            sorted.reserve(pixels);
+            for (double v : q) if (!std::isnan(v)) sorted.push_back(v);
+            std::sort(sorted.begin(), sorted.end());
+            const double total = double(sorted.size());
+            fxParallelFor(pixels, MIN_PIXELS_PER_TASK, [&](size_t begin, size_t end) {
+                for (size_t k = begin; k < end; ++k) {
+                    if (std::isnan(q[k])) continue;
+                    q[k] = (std::upper_bound(sorted.begin(), sorted.end(), q[k]) - sorted.begin()) / total;
+                }
+            });
+        }
+        break;
+    }
+    }
+
+    fxColormap unit = colormap;
+    unit.SetScale(fxColormapScale::Linear);
+    unit.SetRange(0.0, 1.0);
+
+    const size_t width = m_size.GetWidth();
+    wxImage image(m_size.GetWidth(), m_size.GetHeight(), false);
+    image.InitAlpha();
+    unsigned char* rgb = image.GetData();
+    unsigned char* alpha = image.GetAlpha();
+
+    fxParallelFor(m_size.GetHeight(), std::max<size_t>(1, MIN_PIXELS_PER_TASK / width), [&](size_t begin, size_t end) {
+        for (size_t py = begin; py < end; ++py) {
+            const size_t k = py * width;
+            unit.Map(&q[k], width, rgb + 3 * k, alpha + k);
+            // Empty: transparent whatever the NaN colour
+            for (size_t px = 0; px < width; ++px) {
+                if (m_counts[k + px] == 0) alpha[k + px] = 0;
+            }
+        }
+    });
+    return image;
+}
+
+void fxDensityRenderer::Draw(fxDrawingContext& ctx, const fxColormap& colormap,
+                             wxDouble x, wxDouble y, wxDouble w, wxDouble h) const
+{
+    ctx.DrawImage(Shade(colormap), x, y, w, h);
+}
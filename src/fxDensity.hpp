@@ -0,0 +1,84 @@
+// fxDensity.hpp
+
+#ifndef FXDENSITY_HPP
+#define FXDENSITY_HPP
+
+#include <cstdint>
+#include <vector>
+#include <wx/geometry.h>
+#include <wx/image.h>
+#include "fxColormap.hpp"
+#include "fxDrawingContext.hpp"
+
+// How aggregated pixel values are brought to [0, 1] before colouring
+enum class fxDensityTransfer
+{
+    Linear = 0,
+    Log,                // log of the value between the smallest and largest positive one
+    EqualizeHistogram   // rank among the non-empty pixels: every colour is used about equally
+};
+
+// Aggregation of huge point sets into a device-resolution grid.
+//
+// Instead of drawing one marker per point, points are binned into the pixels
+// of the target: each pixel counts the points falling in it (and sums their
+// values, for a mean). Binning runs over all cores, every thread filling its
+// own partial grid, and the partial grids are then summed in parallel. The
+// grid is shaded through a transfer function and a colormap and drawn as one
+// bitmap; empty pixels stay transparent.
+//
+// The data rectangle follows the heatmap convention: y points up, the top
+// image row is the rectangle's largest y.
+class fxDensityRenderer
+{
+public:
+    fxDensityRenderer() = default;
+
+    void SetDataRect(const wxRect2DDouble& rect) { m_dataRect = rect; }
+    const wxRect2DDouble& GetDataRect() const { return m_dataRect; }
+
+    void SetTransfer(fxDensityTransfer transfer) { m_transfer = transfer; }
+    fxDensityTransfer GetTransfer() const { return m_transfer; }
+
+    //================================================
+    // Aggregation (replaces the previous grid)
+    //================================================
+    // Points (x[i], y[i]); with values, pixels are shaded by their mean value
+    // instead of their count
+    void Aggregate(const double* x, const double* y, size_t n, const wxSize& size,
+                   const double* values = nullptr);
+    void Aggregate(const wxPoint2DDouble* points, size_t n, const wxSize& size);
+
+    const wxSize& GetSize() const { return m_size; }
+    const std::vector<uint32_t>& GetCounts() const { return m_counts; }
+    const std::vector<double>& GetSums() const { return m_sums; }   // empty without values
+    bool HasValues() const { return !m_sums.empty(); }
+    uint64_t GetBinnedCount() const { return m_binned; }           // points inside the rectangle
+
+    //================================================
+    // Output
+    //================================================
+    wxImage Shade(const fxColormap& colormap) const;
+
+    // Shade and draw into the rectangle
+    void Draw(fxDrawingContext& ctx, const fxColormap& colormap,
+              wxDouble x, wxDouble y, wxDouble w, wxDouble h) const;
+
+private:
+    wxRect2DDouble    m_dataRect = wxRect2DDouble(0.0, 0.0, 1.0, 1.0);
+    fxDensityTransfer m_transfer = fxDensityTransfer::Log;
+
+    wxSize                m_size;
+    std::vector<uint32_t> m_counts;
+    std::vector<double>   m_sums;
+    uint64_t              m_binned = 0;
+
+    // Per-thread grids, kept to avoid reallocating every frame
+    std::vector<std::vector<uint32_t>> m_partialCounts;
+    std::vector<std::vector<double>>   m_partialSums;
+
+    template <typename PointAt>
+    void AggregateImpl(size_t n, const wxSize& size, const double* values, PointAt pointAt);
+};
+
+#endif // FXDENSITY_HPP
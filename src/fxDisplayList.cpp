@@ -0,0 +1,214 @@
+// fxDisplayList.cpp
+#include "fxDisplayList.hpp"
+#include "fxDrawingContext.hpp"
+#include <algorithm>
+#include <cmath>
+
+void fxDisplayList::Clear()
+{
+    m_commands.clear();
+    m_pens.clear();
+    m_brushes.clear();
+    m_fonts.clear();
+    m_texts.clear();
+    m_paths.clear();
+    m_bitmaps.clear();
+    m_totalCost = 0;
+}
+
+fxDrawCommand& fxDisplayList::Add(fxDrawCommandType type, size_t resource, size_t cost)
+{
+    m_commands.push_back({type, resource});
+    m_commands.back().cost = cost;
+    m_totalCost += cost;
+    return m_commands.back();
+}
+
+//--------------------------------------
+// State changes
+//--------------------------------------
+void fxDisplayList::SetPen(const wxPen& pen)
+{
+    m_pens.push_back(pen);
+    Add(fxDrawCommandType::SetPen, m_pens.size() - 1);
+}
+
+void fxDisplayList::SetBrush(const wxBrush& brush)
+{
+    m_brushes.push_back(brush);
+    Add(fxDrawCommandType::SetBrush, m_brushes.size() - 1);
+}
+
+void fxDisplayList::SetFont(const wxFont& font, const wxColour& colour)
+{
+    m_fonts.emplace_back(font, colour);
+    Add(fxDrawCommandType::SetFont, m_fonts.size() - 1);
+}
+
+void fxDisplayList::SetAntialiasMode(wxAntialiasMode mode)
+{
+    Add(fxDrawCommandType::SetAntialiasMode).mode = static_cast<int>(mode);
+}
+
+void fxDisplayList::Scale(wxDouble xScale, wxDouble yScale)
+{
+    Add(fxDrawCommandType::Scale).points = {{xScale, yScale}};
+}
+
+//--------------------------------------
+// Primitives
+//--------------------------------------
+void fxDisplayList::DrawRectangle(wxDouble x, wxDouble y, wxDouble w, wxDouble h)
+{
+    // Stored as origin + size
+    Add(fxDrawCommandType::DrawRectangle).points = {{x, y}, {w, h}};
+}
+
+void fxDisplayList::DrawText(const wxString& text, wxDouble x, wxDouble y)
+{
+    m_texts.push_back(text);
+    Add(fxDrawCommandType::DrawText, m_texts.size() - 1, text.length()).points = {{x, y}};
+}
+
+void fxDisplayList::DrawText(const wxString& text, wxDouble x, wxDouble y, wxDouble angleRad)
+{
+    m_texts.push_back(text);
+    auto& cmd = Add(fxDrawCommandType::DrawRotatedText, m_texts.size() - 1, text.length());
+    cmd.points = {{x, y}};
+    cmd.angle = angleRad;
+}
+
+void fxDisplayList::StrokeLine(wxDouble x1, wxDouble y1, wxDouble x2, wxDouble y2)
+{
+    Add(fxDrawCommandType::StrokeLine).points = {{x1, y1}, {x2, y2}};
+}
+
+void fxDisplayList::StrokeLines(size_t n, const wxPoint2DDouble* beginPoints, const wxPoint2DDouble* endPoints)
+{
+    // Stored as all begin points followed by all end points
+    auto& cmd = Add(fxDrawCommandType::StrokeLineSegments, 0, 2 * n);
+    cmd.points.reserve(2 * n);
+    cmd.points.insert(cmd.points.end(), beginPoints, beginPoints + n);
+    cmd.points.insert(cmd.points.end(), endPoints, endPoints + n);
+}
+
+void fxDisplayList::StrokeLines(size_t n, const wxPoint2DDouble* points)
+{
+    Add(fxDrawCommandType::StrokeLines, 0, n).points.assign(points, points + n);
+}
+
+//--------------------------------------
+// Paths and bitmaps
+//--------------------------------------
+void fxDisplayList::DrawPath(const fxGraphicsPath& path)
+{
+    m_paths.push_back(path);
+    Add(fxDrawCommandType::DrawPath, m_paths.size() - 1, CountFlattenedVertices(path));
+}
+
+void fxDisplayList::FillPath(const fxGraphicsPath& path, wxPolygonFillMode fillStyle)
+{
+    m_paths.push_back(path);
+    Add(fxDrawCommandType::FillPath, m_paths.size() - 1, CountFlattenedVertices(path)).mode = static_cast<int>(fillStyle);
+}
+
+void fxDisplayList::StrokePath(const fxGraphicsPath& path)
+{
+    m_paths.push_back(path);
+    Add(fxDrawCommandType::StrokePath, m_paths.size() - 1, CountFlattenedVertices(path));
+}
+
+void fxDisplayList::DrawBitmap(const wxBitmap& bitmap, wxDouble x, wxDouble y, wxDouble w, wxDouble h)
+{
+    m_bitmaps.push_back(bitmap);
+    const size_t cost = 1 + static_cast<size_t>(std::abs(w * h)) / 256;
+    auto& cmd = Add(fxDrawCommandType::DrawBitmap, m_bitmaps.size() - 1, cost);
+    cmd.points = {{x, y}, {w, h}};
+    cmd.mode = -1;
+}
+
+void fxDisplayList::DrawBitmap(const wxBitmap& bitmap, wxDouble x, wxDouble y, wxDouble w, wxDouble h,
+                               wxInterpolationQuality interpolation)
+{
+    DrawBitmap(bitmap, x, y, w, h);
+    m_commands.back().mode = static_cast<int>(interpolation);
+}
+
+//--------------------------------------
+// Replay all commands on a context
+//--------------------------------------
+void fxDisplayList::Replay(fxDrawingContext& ctx) const
+{
+    for (const auto& cmd : m_commands) {
+        ReplayCommand(ctx, cmd);
+    }
+}
+
+void fxDisplayList::Replay(fxDrawingContext& ctx, size_t first, size_t last) const
+{
+    last = std::min(last, m_commands.size());
+    for (size_t i = first; i < last; ++i) {
+        ReplayCommand(ctx, m_commands[i]);
+    }
+}
+
+void fxDisplayList::ReplayCommand(fxDrawingContext& ctx, const fxDrawCommand& cmd) const
+{
+    const auto& p = cmd.points;
+    switch (cmd.type)
+    {
+    case fxDrawCommandType::SetPen:
+        ctx.SetPen(m_pens[cmd.resource]);
+        break;
+    case fxDrawCommandType::SetBrush:
+        ctx.SetBrush(m_brushes[cmd.resource]);
+        break;
+    case fxDrawCommandType::SetFont:
+        ctx.SetFont(m_fonts[cmd.resource].first, m_fonts[cmd.resource].second);
+        break;
+    case fxDrawCommandType::SetAntialiasMode:
+        ctx.SetAntialiasMode(static_cast<wxAntialiasMode>(cmd.mode));
+        break;
+    case fxDrawCommandType::Scale:
+        ctx.Scale(p[0].m_x, p[0].m_y);
+        break;
+    case fxDrawCommandType::DrawRectangle:
+        ctx.DrawRectangle(p[0].m_x, p[0].m_y, p[1].m_x, p[1].m_y);
+        break;
+    case fxDrawCommandType::DrawText:
+        ctx.DrawText(m_texts[cmd.resource], p[0].m_x, p[0].m_y);
+        break;
+    case fxDrawCommandType::DrawRotatedText:
+        ctx.DrawText(m_texts[cmd.resource], p[0].m_x, p[0].m_y, cmd.angle);
+        break;
+    case fxDrawCommandType::StrokeLine:
+        ctx.StrokeLine(p[0].m_x, p[0].m_y, p[1].m_x, p[1].m_y);
+        break;
+    case fxDrawCommandType::StrokeLineSegments:
+        {
+            const size_t n = p.size() / 2;
+            ctx.StrokeLines(n, p.data(), p.data() + n);
+        }
+        break;
+    case fxDrawCommandType::StrokeLines:
+        ctx.StrokeLines(p.size(), p.data());
+        break;
+    case fxDrawCommandType::DrawPath:
+        ctx.DrawPath(m_paths[cmd.resource]);
+        break;
+    case fxDrawCommandType::FillPath:
+        ctx.FillPath(m_paths[cmd.resource], static_cast<wxPolygonFillMode>(cmd.mode));
+        break;
+    case fxDrawCommandType::StrokePath:
+        ctx.StrokePath(m_paths[cmd.resource]);
+        break;
+    case fxDrawCommandType::DrawBitmap:
+        if (cmd.mode < 0) {
+            ctx.DrawBitmap(m_bitmaps[cmd.resource], p[0].m_x, p[0].m_y, p[1].m_x, p[1].m_y);
+        } else {
+            ctx.DrawBitmap(m_bitmaps[cmd.resource], p[0].m_x, p[0].m_y, p[1].m_x, p[1].m_y,
+                           static_cast<wxInterpolationQuality>(cmd.mode));
+        }
+        break;
+    }
+}
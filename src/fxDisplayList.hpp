@@ -0,0 +1,115 @@
+// fxDisplayList.hpp
+
+#ifndef FXDISPLAYLIST_HPP
+#define FXDISPLAYLIST_HPP
+
+#include <wx/graphics.h>
+#include <wx/bitmap.h>
+#include <vector>
+#include <utility>
+#include "fxGraphicsPath.hpp"
+
+class fxDrawingContext;
+
+// Recorded drawing operations
+enum class fxDrawCommandType {
+    SetPen,
+    SetBrush,
+    SetFont,
+    SetAntialiasMode,
+    Scale,
+    DrawRectangle,
+    DrawText,
+    DrawRotatedText,
+    StrokeLine,
+    StrokeLineSegments,
+    StrokeLines,
+    DrawPath,
+    FillPath,
+    StrokePath,
+    DrawBitmap
+};
+
+struct fxDrawCommand {
+    fxDrawCommandType type;
+    size_t resource = 0;                  // index into the matching resource pool
+    std::vector<wxPoint2DDouble> points;  // coordinates, sizes or scale factors
+    double angle = 0.0;                   // text rotation (radians)
+    int mode = 0;                         // fill rule, antialias mode or interpolation (-1: playback's)
+    size_t cost = 1;                      // work estimate: vertices, glyphs or pixels/256
+};
+
+// A replayable list of drawing commands.
+// Pens, brushes, fonts, strings, paths and bitmaps are kept in separate pools,
+// so that commands stay small and the resources are shared by reference.
+// Recorded paths keep their segment geometry; replaying on a GC rebuilds the
+// native path there (see fxGraphicsPath::GetPathFor).
+class fxDisplayList
+{
+public:
+    fxDisplayList() = default;
+
+    void Clear();
+    bool IsEmpty() const { return m_commands.empty(); }
+    size_t GetCount() const { return m_commands.size(); }
+
+    //================================================
+    // Recording
+    //================================================
+    void SetPen(const wxPen& pen);
+    void SetBrush(const wxBrush& brush);
+    void SetFont(const wxFont& font, const wxColour& colour);
+    void SetAntialiasMode(wxAntialiasMode mode);
+    void Scale(wxDouble xScale, wxDouble yScale);
+
+    void DrawRectangle(wxDouble x, wxDouble y, wxDouble w, wxDouble h);
+    void DrawText(const wxString& text, wxDouble x, wxDouble y);
+    void DrawText(const wxString& text, wxDouble x, wxDouble y, wxDouble angleRad);
+    void StrokeLine(wxDouble x1, wxDouble y1, wxDouble x2, wxDouble y2);
+    void StrokeLines(size_t n, const wxPoint2DDouble* beginPoints, const wxPoint2DDouble* endPoints);
+    void StrokeLines(size_t n, const wxPoint2DDouble* points);
+
+    void DrawPath(const fxGraphicsPath& path);
+    void FillPath(const fxGraphicsPath& path, wxPolygonFillMode fillStyle);
+    void StrokePath(const fxGraphicsPath& path);
+
+    void DrawBitmap(const wxBitmap& bitmap, wxDouble x, wxDouble y, wxDouble w, wxDouble h);
+    void DrawBitmap(const wxBitmap& bitmap, wxDouble x, wxDouble y, wxDouble w, wxDouble h,
+                    wxInterpolationQuality interpolation);
+
+    //================================================
+    // Playback
+    //================================================
+    void Replay(fxDrawingContext& ctx) const;
+
+    // Replay commands [first, last) only, e.g. to spread work over frames
+    void Replay(fxDrawingContext& ctx, size_t first, size_t last) const;
+
+    // Sum of the command costs
+    size_t GetTotalCost() const { return m_totalCost; }
+
+    //================================================
+    // Accessors
+    //================================================
+    const std::vector<fxDrawCommand>& GetCommands() const { return m_commands; }
+    const std::vector<fxGraphicsPath>& GetPaths() const { return m_paths; }
+    const std::vector<wxString>& GetTexts() const { return m_texts; }
+
+private:
+    std::vector<fxDrawCommand> m_commands;
+
+    // Resource pools, referenced by fxDrawCommand::resource
+    std::vector<wxPen>    m_pens;
+    std::vector<wxBrush>  m_brushes;
+    std::vector<std::pair<wxFont, wxColour>> m_fonts;
+    std::vector<wxString> m_texts;
+    std::vector<fxGraphicsPath> m_paths;
+    std::vector<wxBitmap> m_bitmaps;
+
+    size_t m_totalCost = 0;
+
+    fxDrawCommand& Add(fxDrawCommandType type, size_t resource = 0, size_t cost = 1);
+    void ReplayCommand(fxDrawingContext& ctx, const fxDrawCommand& cmd) const;
+};
+
+#endif // FXDISPLAYLIST_HPP
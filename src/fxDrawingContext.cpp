@@ -1,5 +1,7 @@
 // fxDrawingContext.cpp
 #include "fxDrawingContext.hpp"
+#include "fxDisplayList.hpp"
+#include "fxTrace.hpp"
 #include <wx/graphics.h>
 #include <wx/dcgraph.h>
 #include <wx/log.h>
@@ -7,6 +9,14 @@
 #include <wx/dcprint.h>
 #include <wx/dcclient.h>
 #include <wx/dc.h>
+#include <wx/image.h>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+// Decimating a handful of points isn't worth the copy
+const size_t MIN_DECIMATION_POINTS = 64;
+} // namespace
 
 //---------------------------------------------------------
 // Constructor from wxGraphicsContext*
@@ -25,7 +35,7 @@ fxDrawingContext::fxDrawingContext(wxGraphicsContext* gc)
 //---------------------------------------------------------
 // Constructor from wxDC*
 //---------------------------------------------------------
-fxDrawingContext::fxDrawingContext(wxDC* dc)
+fxDrawingContext::fxDrawingContext(wxDC* dc, bool createGC)
 {
     if (!dc) {
         // null DC => monostate
@@ -40,7 +50,10 @@ fxDrawingContext::fxDrawingContext(wxDC* dc)
 
     wxGraphicsContext* rawGC = nullptr;
 
-    if (windowDC) {
+    if (!createGC) {
+        // Keep the plain DC
+    }
+    else if (windowDC) {
         // We have a wxWindowDC
         rawGC = wxGraphicsContext::Create(*windowDC);
     }
@@ -53,6 +66,9 @@ fxDrawingContext::fxDrawingContext(wxDC* dc)
         rawGC = wxGraphicsContext::Create(*printerDC);
     }
 
+    // Printers and the fallback DCs (e.g. wxSVGFileDC) are not pixel targets
+    m_vectorTarget = printerDC || (!windowDC && !memoryDC);
+
     if (rawGC) {
         // We successfully created a GC
         m_context = rawGC;
@@ -131,6 +147,18 @@ void fxDrawingContext::GetSize(wxDouble* width, wxDouble* height) const
         // else monostate: do nothing (already set to 0 above)
     }, m_context);
 }
+
+wxSize fxDrawingContext::GetDeviceSize(wxDouble w, wxDouble h) const
+{
+    if (auto gc = std::get_if<wxGraphicsContext*>(&m_context); gc && *gc) {
+        // Lengths of the transformed unit vectors
+        wxDouble a, b, c, d;
+        (*gc)->GetTransform().Get(&a, &b, &c, &d);
+        return wxSize(static_cast<int>(std::ceil(std::abs(w) * std::hypot(a, b))),
+                      static_cast<int>(std::ceil(std::abs(h) * std::hypot(c, d))));
+    }
+    return wxSize(static_cast<int>(std::lround(std::abs(w))), static_cast<int>(std::lround(std::abs(h))));
+}
     
 // -------------------------------------------------------------
 // SetFont: unify font setting for GC and DC
@@ -139,6 +167,14 @@ void fxDrawingContext::GetSize(wxDouble* width, wxDouble* height) const
 // For wxDC: SetFont + SetTextForeground
 void fxDrawingContext::SetFont(const wxFont& font, const wxColour& colour)
 {
+    // Fonts are recorded *and* applied: text measurement must stay accurate
+    if (m_recorder) m_recorder->SetFont(font, colour);
+
+    FX_STATS_SCOPE(m_stats, SetFont);
+    FX_STATS_IF(if (!(font == m_font) || colour != m_fontColour) ++m_stats.stateChanges;)
+    m_font = font;
+    m_fontColour = colour;
+
     std::visit([&](auto&& ctx){
         using T = std::decay_t<decltype(ctx)>;
         if constexpr (std::is_same_v<T, wxGraphicsContext*>) {
@@ -195,6 +231,8 @@ void fxDrawingContext::GetTextExtent(const wxString& text,
                                      wxDouble* descent,
                                      wxDouble* externalLeading) const
 {
+    FX_STATS_SCOPE(m_stats, TextExtent);
+    FX_TRACE_SCOPE(Text, "GetTextExtent");
     // Initialize outputs if provided
     auto setIfNotNull = [](wxDouble* p, double val){ if(p) *p = val; };
 
@@ -266,6 +304,11 @@ void fxDrawingContext::GetTextSize(const wxFont& font,
 //--------------------------------------
 void fxDrawingContext::SetBrush(const wxBrush& brush)
 {
+    if (m_recorder) { m_recorder->SetBrush(brush); return; }
+    FX_STATS_SCOPE(m_stats, SetBrush);
+    FX_STATS_IF(if (brush != m_brush) ++m_stats.stateChanges;)
+    m_brush = brush;
+
     std::visit([&](auto&& ctx) {
         using T = std::decay_t<decltype(ctx)>;
         if constexpr (std::is_same_v<T, wxGraphicsContext*>) {
@@ -278,6 +321,11 @@ void fxDrawingContext::SetBrush(const wxBrush& brush)
 
 void fxDrawingContext::SetPen(const wxPen& pen)
 {
+    if (m_recorder) { m_recorder->SetPen(pen); return; }
+    FX_STATS_SCOPE(m_stats, SetPen);
+    FX_STATS_IF(if (pen != m_pen) ++m_stats.stateChanges;)
+    m_pen = pen;
+
     std::visit([&](auto&& ctx) {
         using T = std::decay_t<decltype(ctx)>;
         if constexpr (std::is_same_v<T, wxGraphicsContext*>) {
@@ -290,6 +338,10 @@ void fxDrawingContext::SetPen(const wxPen& pen)
 
 void fxDrawingContext::DrawRectangle(wxDouble x, wxDouble y, wxDouble w, wxDouble h)
 {
+    if (m_recorder) { m_recorder->DrawRectangle(x, y, w, h); return; }
+    FX_STATS_SCOPE(m_stats, DrawRectangle);
+    FX_STATS_ADD(m_stats, vertices, 4);
+
     std::visit([&](auto&& ctx) {
         using T = std::decay_t<decltype(ctx)>;
         if constexpr (std::is_same_v<T, wxGraphicsContext*>) {
@@ -306,6 +358,12 @@ void fxDrawingContext::DrawRectangle(wxDouble x, wxDouble y, wxDouble w, wxDoubl
 //--------------------------------------
 void fxDrawingContext::DrawText(const wxString& text, wxDouble x, wxDouble y)
 {
+    if (m_recorder) { m_recorder->DrawText(text, x, y); return; }
+    if (m_quality.minTextHeight > 0.0 && GetFontHeight() < m_quality.minTextHeight) return;
+    if (m_quality.placeholderText) { DrawTextPlaceholder(text, x, y, 0.0); return; }
+    FX_STATS_SCOPE(m_stats, DrawText);
+    FX_TRACE_SCOPE(Backend, "DrawText");
+
     std::visit([&](auto&& ctx) {
         using T = std::decay_t<decltype(ctx)>;
         if constexpr (std::is_same_v<T, wxGraphicsContext*>) {
@@ -318,6 +376,12 @@ void fxDrawingContext::DrawText(const wxString& text, wxDouble x, wxDouble y)
 
 void fxDrawingContext::DrawText(const wxString& text, wxDouble x, wxDouble y, wxDouble angleRad)
 {
+    if (m_recorder) { m_recorder->DrawText(text, x, y, angleRad); return; }
+    if (m_quality.minTextHeight > 0.0 && GetFontHeight() < m_quality.minTextHeight) return;
+    if (m_quality.placeholderText) { DrawTextPlaceholder(text, x, y, angleRad); return; }
+    FX_STATS_SCOPE(m_stats, DrawText);
+    FX_TRACE_SCOPE(Backend, "DrawText");
+
     std::visit([&](auto&& ctx) {
         using T = std::decay_t<decltype(ctx)>;
 
@@ -340,6 +404,12 @@ void fxDrawingContext::DrawText(const wxString& text, wxDouble x, wxDouble y, wx
 
 fxGraphicsPath fxDrawingContext::CreatePath()
 {
+    // Recorded paths must not be tied to the current target
+    if (m_recorder) {
+        return fxGraphicsPath(nullptr);
+    }
+
+    FX_STATS_SCOPE(m_stats, CreatePath);
     wxGraphicsContext* actualGC = nullptr;
 
     std::visit([&](auto&& c) {
@@ -354,17 +424,18 @@ fxGraphicsPath fxDrawingContext::CreatePath()
             // We only have a plain DC (e.g. wxSVGFileDC, wxMemoryDC, etc.)
             // => do not attempt to create a GC
             // => fallback will rely on fxPathSegment geometry
-            wxLogDebug("fxDrawingContext::NewPath() => DC only => fallback (no GC).");
+            FX_STATS_LOG("fxDrawingContext::NewPath() => DC only => fallback (no GC).");
         }
     }, m_context);
 
     if (!actualGC) {
         // We'll have to do tracking-only
-        wxLogDebug("fxDrawingContext::NewPath() => actualGC == nullptr, returning fxGraphicsPath(nullptr).");
+        FX_STATS_LOG("fxDrawingContext::NewPath() => actualGC == nullptr, returning fxGraphicsPath(nullptr).");
         return fxGraphicsPath(nullptr);
     }
 
     // If we do have a GC, build a path with it
+    FX_STATS_ADD(m_stats, nativeObjects, 1);
     return fxGraphicsPath(actualGC);
 }
 
@@ -373,18 +444,26 @@ fxGraphicsPath fxDrawingContext::CreatePath()
 //--------------------------------------
 void fxDrawingContext::DrawPath(const fxGraphicsPath& fxpath)
 {
+    if (m_recorder) { m_recorder->DrawPath(fxpath); return; }
+    FX_STATS_SCOPE(m_stats, DrawPath);
+    FX_TRACE_SCOPE(Backend, "DrawPath");
+
+    fxGraphicsPath storage;
+    const fxGraphicsPath& path = ForQuality(fxpath, storage);
+    FX_STATS_IF(AddPathStats(fxpath, path);)
+
     std::visit([&](auto&& ctx) {
         using T = std::decay_t<decltype(ctx)>;
         if constexpr (std::is_same_v<T, wxGraphicsContext*>) {
             if (ctx) {
-                // Use native DrawPath
-                ctx->DrawPath(fxpath.GetPath());
+                // Use native DrawPath (rebuilt if the path belongs elsewhere)
+                ctx->DrawPath(path.GetPathFor(ctx));
             }
         }
         else if constexpr (std::is_same_v<T, wxDC*>) {
             if (ctx) {
                 // Fallback: interpret geometry from fxGraphicsPath
-                DrawPathOnDC(ctx, fxpath);
+                DrawPathOnDC(ctx, path, wxODDEVEN_RULE, m_quality.flatteningTolerance);
             }
         }
     }, m_context);
@@ -393,15 +472,31 @@ void fxDrawingContext::DrawPath(const fxGraphicsPath& fxpath)
 //--------------------------------------
 // Fallback for drawing path geometry on plain wxDC
 //--------------------------------------
-void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMode)
+void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMode, double tolerance)
 {
     if (!dc) return;
     const auto& segments = path.GetSegments();
     if (segments.empty()) return;
+    FX_TRACE_SCOPE(Path, "FlattenOnDC");
 
     std::vector<wxPoint> currentSubpath;
     currentSubpath.reserve(16);
 
+    // Consecutive closed subpaths, filled together so that the fill rule
+    // sees all of them (holes of even-odd shapes are other subpaths). They
+    // are flushed before any other primitive to keep the path order.
+    std::vector<wxPoint> polygons;
+    std::vector<int> polygonCounts;
+    const auto flushPolygons = [&]() {
+        if (polygonCounts.size() == 1) {
+            dc->DrawPolygon(polygons.size(), polygons.data(), 0, 0, fillMode);
+        } else if (!polygonCounts.empty()) {
+            dc->DrawPolyPolygon(polygonCounts.size(), polygonCounts.data(), polygons.data(), 0, 0, fillMode);
+        }
+        polygons.clear();
+        polygonCounts.clear();
+    };
+
     // We'll keep track of the last point, to connect lines or arcs
     wxPoint2DDouble lastPt(0,0);
     bool haveLastPt = false;
@@ -414,6 +509,7 @@ void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMo
             {
                 // If we have an open subpath, fill it:
                 if (!currentSubpath.empty()) {
+                    flushPolygons();
                     dc->DrawLines(currentSubpath.size(), currentSubpath.data());
                     currentSubpath.clear();
                 }
@@ -435,6 +531,18 @@ void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMo
             }
             break;
 
+        case fxPathSegmentType::Polyline:
+            {
+                for (const auto& pt : seg.points) {
+                    currentSubpath.push_back(wxPoint((int)pt.m_x, (int)pt.m_y));
+                }
+                if (!seg.points.empty()) {
+                    lastPt = seg.points.back();
+                    haveLastPt = true;
+                }
+            }
+            break;
+
         //-----------------------------------
         // Quadratic Bezier
         //-----------------------------------
@@ -442,7 +550,8 @@ void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMo
             {
                 // We have control point (cx,cy) and end point (x,y)
                 if (seg.points.size() >= 2 && haveLastPt) {
-                    auto poly = ApproxQuadBezier(lastPt, seg.points[0], seg.points[1], 12);
+                    int steps = QuadBezierSteps(lastPt, seg.points[0], seg.points[1], tolerance);
+                    auto poly = ApproxQuadBezier(lastPt, seg.points[0], seg.points[1], steps);
                     // The first point is lastPt again, so skip it to avoid duplication
                     for (size_t i=1; i<poly.size(); i++){
                         currentSubpath.push_back(wxPoint((int)poly[i].m_x, (int)poly[i].m_y));
@@ -458,7 +567,8 @@ void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMo
         case fxPathSegmentType::CurveTo:
             {
                 if (seg.points.size() >= 3 && haveLastPt) {
-                    auto poly = ApproxCubicBezier(lastPt, seg.points[0], seg.points[1], seg.points[2], 12);
+                    int steps = CubicBezierSteps(lastPt, seg.points[0], seg.points[1], seg.points[2], tolerance);
+                    auto poly = ApproxCubicBezier(lastPt, seg.points[0], seg.points[1], seg.points[2], steps);
                     for (size_t i=1; i<poly.size(); i++){
                         currentSubpath.push_back(wxPoint((int)poly[i].m_x, (int)poly[i].m_y));
                     }
@@ -479,7 +589,8 @@ void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMo
                     bool cw       = seg.clockwise;
                     // If we have a 'lastPt' we could do a line from lastPt to arc start, 
                     // but in wxGraphicsPath AddArc typically 'moves' to start of arc first.
-                    auto arcPts = ApproxArc(seg.points[0], r, startA, endA, cw, 12);
+                    int steps = ArcSteps(r, endA - startA, tolerance);
+                    auto arcPts = ApproxArc(seg.points[0], r, startA, endA, cw, steps);
                     // optional: if you want a line from lastPt to arcPts[0], do so
                     for (size_t i = 0; i < arcPts.size(); i++){
                         currentSubpath.push_back(wxPoint((int)arcPts[i].m_x, (int)arcPts[i].m_y));
@@ -523,6 +634,7 @@ void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMo
                 wxDouble y1 = seg.points[0].m_y;
                 wxDouble x2 = seg.points[1].m_x;
                 wxDouble y2 = seg.points[1].m_y;
+                flushPolygons();
                 dc->DrawRectangle(wxRect((int)x1, (int)y1, (int)(x2 - x1), (int)(y2 - y1)));
             }
             break;
@@ -531,7 +643,7 @@ void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMo
         {
             if (seg.points.size() >= 2) {
                 const double r = seg.radius;
-                const int steps = 6;
+                const int steps = ArcSteps(r, M_PI / 2, tolerance, 6);
 
                 double x1 = seg.points[0].m_x;
                 double y1 = seg.points[0].m_y;
@@ -554,6 +666,7 @@ void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMo
                 for (const auto& pt : arcBR) outline.emplace_back(wxPoint(int(pt.m_x), int(pt.m_y)));
                 for (const auto& pt : arcBL) outline.emplace_back(wxPoint(int(pt.m_x), int(pt.m_y)));
 
+                flushPolygons();
                 dc->DrawPolygon(outline.size(), outline.data(), 0, 0, fillMode);
 
                 if (!outline.empty()) {
@@ -568,6 +681,7 @@ void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMo
         case fxPathSegmentType::Ellipse:
             // Already handled or partial. If its bounding box or circle center, see code snippet:
             {
+                flushPolygons();
                 if (seg.points.size() == 1) {
                     // (center, radius)
                     double cx = seg.points[0].m_x;
@@ -588,7 +702,8 @@ void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMo
         case fxPathSegmentType::Close:
             {
                 if (!currentSubpath.empty()) {
-                    dc->DrawPolygon(currentSubpath.size(), currentSubpath.data(), 0, 0, fillMode);
+                    polygons.insert(polygons.end(), currentSubpath.begin(), currentSubpath.end());
+                    polygonCounts.push_back(static_cast<int>(currentSubpath.size()));
                     currentSubpath.clear();
                 }
             }
@@ -601,6 +716,8 @@ void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMo
         }
     }
 
+    flushPolygons();
+
     // If there's an open subpath, draw it as lines
     if (!currentSubpath.empty()) {
         dc->DrawLines(currentSubpath.size(), currentSubpath.data());
@@ -610,70 +727,194 @@ void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMo
 void fxDrawingContext::FillPath(const fxGraphicsPath& fxpath, 
                                 wxPolygonFillMode fillStyle)
 {
+    if (m_recorder) { m_recorder->FillPath(fxpath, fillStyle); return; }
+    FX_STATS_SCOPE(m_stats, FillPath);
+    FX_TRACE_SCOPE(Backend, "FillPath");
+
+    fxGraphicsPath storage;
+    const fxGraphicsPath& path = ForQuality(fxpath, storage);
+    FX_STATS_IF(AddPathStats(fxpath, path);)
+
     std::visit([&](auto&& c){
         using T = std::decay_t<decltype(c)>;
 
         if constexpr (std::is_same_v<T, wxGraphicsContext*>) {
             // If we have a real GC, use native FillPath
             if (c) {
-                c->FillPath(fxpath.GetPath(), fillStyle);
+                c->FillPath(path.GetPathFor(c), fillStyle);
             }
         }
         else if constexpr (std::is_same_v<T, wxDC*>) {
             // Fallback for DC
             if (c) {
-                FillPathOnDC(c, fxpath, fillStyle);
+                FillPathOnDC(c, path, fillStyle, m_quality.flatteningTolerance);
             }
         }
     }, m_context);
 }
 
-void FillPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMode)
+void FillPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMode, double tolerance)
 {
     if (!dc) return;
 
     wxPen oldPen = dc->GetPen();
     dc->SetPen(*wxTRANSPARENT_PEN);  // Fill only: no stroke
 
-    DrawPathOnDC(dc, path, fillMode);  // Use correct fill mode
+    DrawPathOnDC(dc, path, fillMode, tolerance);  // Use correct fill mode
 
     dc->SetPen(oldPen);  // Restore original
 }
 
 void fxDrawingContext::StrokePath(const fxGraphicsPath& fxpath)
 {
+    if (m_recorder) { m_recorder->StrokePath(fxpath); return; }
+    FX_STATS_SCOPE(m_stats, StrokePath);
+    FX_TRACE_SCOPE(Backend, "StrokePath");
+
+    fxGraphicsPath storage;
+    const fxGraphicsPath& path = ForQuality(fxpath, storage);
+    FX_STATS_IF(AddPathStats(fxpath, path);)
+
     std::visit([&](auto&& c){
         using T = std::decay_t<decltype(c)>;
         if constexpr (std::is_same_v<T, wxGraphicsContext*>) {
             if (c) {
-                c->StrokePath(fxpath.GetPath());
+                c->StrokePath(path.GetPathFor(c));
             }
         }
         else if constexpr (std::is_same_v<T, wxDC*>) {
             if (c) {
-                StrokePathOnDC(c, fxpath);
+                StrokePathOnDC(c, path, m_quality.flatteningTolerance);
             }
         }
     }, m_context);
 }
 
-void StrokePathOnDC(wxDC* dc, const fxGraphicsPath& path)
+void StrokePathOnDC(wxDC* dc, const fxGraphicsPath& path, double tolerance)
 {
     if (!dc) return;
 
     wxBrush oldBrush = dc->GetBrush();
     dc->SetBrush(*wxTRANSPARENT_BRUSH);  // Stroke only: no fill
 
-    DrawPathOnDC(dc, path, wxODDEVEN_RULE);  // Polygon mode doesn't matter for stroke
+    DrawPathOnDC(dc, path, wxODDEVEN_RULE, tolerance);  // Polygon mode doesn't matter for stroke
 
     dc->SetBrush(oldBrush);  // Restore original
 }
 
+//--------------------------------------
+// Path views
+//--------------------------------------
+void fxDrawingContext::DrawPath(const fxPathView& view)
+{
+    if (m_recorder) { m_recorder->DrawPath(view.ToPath()); return; }
+    FX_STATS_SCOPE(m_stats, DrawPath);
+    FX_TRACE_SCOPE(Backend, "DrawPathView");
+    RenderView(view, ViewOp::Draw, wxODDEVEN_RULE);
+}
+
+void fxDrawingContext::FillPath(const fxPathView& view, wxPolygonFillMode fillStyle)
+{
+    if (m_recorder) { m_recorder->FillPath(view.ToPath(), fillStyle); return; }
+    FX_STATS_SCOPE(m_stats, FillPath);
+    FX_TRACE_SCOPE(Backend, "FillPathView");
+    RenderView(view, ViewOp::Fill, fillStyle);
+}
+
+void fxDrawingContext::StrokePath(const fxPathView& view)
+{
+    if (m_recorder) { m_recorder->StrokePath(view.ToPath()); return; }
+    FX_STATS_SCOPE(m_stats, StrokePath);
+    FX_TRACE_SCOPE(Backend, "StrokePathView");
+    RenderView(view, ViewOp::Stroke, wxODDEVEN_RULE);
+}
+
+void fxDrawingContext::RenderView(const fxPathView& view, ViewOp op, wxPolygonFillMode fillStyle)
+{
+    if (view.IsEmpty()) return;
+
+    // The radial-distance decimation of fxGraphicsPath::Decimated, while reading
+    const double tolerance = view.GetSize() >= MIN_DECIMATION_POINTS ? m_quality.decimationTolerance : 0.0;
+    const double tol2 = tolerance * tolerance;
+    auto forEachKept = [&](auto&& emit) {
+        const size_t lastIndex = view.GetSize() - 1;
+        size_t index = 0;
+        wxPoint2DDouble kept;
+        view.ForEach([&](const wxPoint2DDouble& p) {
+            const double dx = p.m_x - kept.m_x;
+            const double dy = p.m_y - kept.m_y;
+            if (index == 0 || index == lastIndex || !(dx * dx + dy * dy < tol2)) {
+                emit(p);
+                kept = p;
+            }
+            ++index;
+        });
+    };
+
+    std::visit([&](auto&& c) {
+        using T = std::decay_t<decltype(c)>;
+        if constexpr (std::is_same_v<T, wxGraphicsContext*>) {
+            if (!c) return;
+            // Straight into a native path
+            wxGraphicsPath path = c->CreatePath();
+            size_t count = 0;
+            forEachKept([&](const wxPoint2DDouble& p) {
+                if (count++ == 0) path.MoveToPoint(p.m_x, p.m_y);
+                else path.AddLineToPoint(p.m_x, p.m_y);
+            });
+            if (view.IsClosed()) path.CloseSubpath();
+            FX_STATS_ADD(m_stats, vertices, count);
+            FX_STATS_ADD(m_stats, nativeObjects, 1);
+
+            switch (op) {
+            case ViewOp::Draw:   c->DrawPath(path, fillStyle); break;
+            case ViewOp::Fill:   c->FillPath(path, fillStyle); break;
+            case ViewOp::Stroke: c->StrokePath(path); break;
+            }
+        }
+        else if constexpr (std::is_same_v<T, wxDC*>) {
+            if (!c) return;
+            std::vector<wxPoint> points;
+            points.reserve(view.GetSize());
+            forEachKept([&](const wxPoint2DDouble& p) { points.push_back(wxPoint((int)p.m_x, (int)p.m_y)); });
+            FX_STATS_ADD(m_stats, vertices, points.size());
+            FX_STATS_ADD(m_stats, bytesAllocated, points.size() * sizeof(wxPoint));
+
+            // Same primitives as DrawPathOnDC, except that fills close open views
+            switch (op) {
+            case ViewOp::Draw:
+                if (view.IsClosed()) c->DrawPolygon(points.size(), points.data(), 0, 0, fillStyle);
+                else c->DrawLines(points.size(), points.data());
+                break;
+            case ViewOp::Fill: {
+                const wxPen oldPen = c->GetPen();
+                c->SetPen(*wxTRANSPARENT_PEN);
+                c->DrawPolygon(points.size(), points.data(), 0, 0, fillStyle);
+                c->SetPen(oldPen);
+                break;
+            }
+            case ViewOp::Stroke:
+                if (view.IsClosed()) {
+                    const wxBrush oldBrush = c->GetBrush();
+                    c->SetBrush(*wxTRANSPARENT_BRUSH);
+                    c->DrawPolygon(points.size(), points.data(), 0, 0, fillStyle);
+                    c->SetBrush(oldBrush);
+                } else {
+                    c->DrawLines(points.size(), points.data());
+                }
+                break;
+            }
+        }
+    }, m_context);
+}
+
 //--------------------------------------
 // Flush (if supported)
 //--------------------------------------
 void fxDrawingContext::Flush()
 {
+    FX_STATS_SCOPE(m_stats, Flush);
+    FX_TRACE_SCOPE(Backend, "Flush");
     std::visit([&](auto&& c) {
         using T = std::decay_t<decltype(c)>;
 
@@ -697,6 +938,10 @@ void fxDrawingContext::Flush()
 //--------------------------------------
 void fxDrawingContext::StrokeLine(wxDouble x1, wxDouble y1, wxDouble x2, wxDouble y2)
 {
+    if (m_recorder) { m_recorder->StrokeLine(x1, y1, x2, y2); return; }
+    FX_STATS_SCOPE(m_stats, StrokeLine);
+    FX_STATS_ADD(m_stats, vertices, 2);
+
     std::visit([&](auto&& ctx) {
         using T = std::decay_t<decltype(ctx)>;
 
@@ -714,6 +959,10 @@ void fxDrawingContext::StrokeLine(wxDouble x1, wxDouble y1, wxDouble x2, wxDoubl
 
 void fxDrawingContext::StrokeLines(size_t n, const wxPoint2DDouble* beginPoints, const wxPoint2DDouble* endPoints)
 {
+    if (m_recorder) { m_recorder->StrokeLines(n, beginPoints, endPoints); return; }
+    FX_STATS_SCOPE(m_stats, StrokeLines);
+    FX_STATS_ADD(m_stats, vertices, 2 * n);
+
     std::visit([&](auto&& ctx) {
         using T = std::decay_t<decltype(ctx)>;
 
@@ -736,6 +985,10 @@ void fxDrawingContext::StrokeLines(size_t n, const wxPoint2DDouble* beginPoints,
 
 void fxDrawingContext::StrokeLines(size_t n, const wxPoint2DDouble* points)
 {
+    if (m_recorder) { m_recorder->StrokeLines(n, points); return; }
+    FX_STATS_SCOPE(m_stats, StrokeLines);
+    FX_STATS_ADD(m_stats, vertices, n);
+
     std::visit([&](auto&& ctx) {
         using T = std::decay_t<decltype(ctx)>;
 
@@ -758,6 +1011,8 @@ void fxDrawingContext::StrokeLines(size_t n, const wxPoint2DDouble* points)
 
 void fxDrawingContext::Scale(wxDouble xScale, wxDouble yScale)
 {
+    if (m_recorder) { m_recorder->Scale(xScale, yScale); return; }
+
     std::visit([&](auto&& ctx){
         using T = std::decay_t<decltype(ctx)>;
         if constexpr (std::is_same_v<T, wxGraphicsContext*>)
@@ -773,6 +1028,11 @@ void fxDrawingContext::Scale(wxDouble xScale, wxDouble yScale)
 
 bool fxDrawingContext::SetAntialiasMode(wxAntialiasMode mode)
 {
+    if (m_recorder) {
+        m_recorder->SetAntialiasMode(mode);
+        return true;
+    }
+
     bool supported = false;
 
     std::visit([&](auto&& ctx){
@@ -786,6 +1046,8 @@ bool fxDrawingContext::SetAntialiasMode(wxAntialiasMode mode)
         // wxDC doesn't support antialiasing mode  leave as false
     }, m_context);
 
+    // Remembered either way, so that GetAntialiasMode() reports it
+    m_quality.antialias = mode;
     return supported;
 }
 
@@ -801,9 +1063,250 @@ wxAntialiasMode fxDrawingContext::GetAntialiasMode() const
                 mode = ctx->GetAntialiasMode();
             }
         }
-        // wxDC has no AA mode  leave as default
+        else if constexpr (std::is_same_v<T, wxDC*>)
+        {
+            // wxDC has no AA mode  report the requested one
+            mode = m_quality.antialias;
+        }
     }, m_context);
 
     return mode;
 }
 
+//--------------------------------------
+// DrawBitmap
+//--------------------------------------
+void fxDrawingContext::DrawBitmap(const wxBitmap& bitmap, wxDouble x, wxDouble y, wxDouble w, wxDouble h)
+{
+    // Recorded without interpolation: the playback quality decides
+    if (m_recorder) { m_recorder->DrawBitmap(bitmap, x, y, w, h); return; }
+    DrawBitmap(bitmap, x, y, w, h, m_quality.interpolation);
+}
+
+void fxDrawingContext::DrawBitmap(const wxBitmap& bitmap, wxDouble x, wxDouble y, wxDouble w, wxDouble h,
+                                  wxInterpolationQuality interpolation)
+{
+    if (m_recorder) { m_recorder->DrawBitmap(bitmap, x, y, w, h, interpolation); return; }
+    if (!bitmap.IsOk()) return;
+    FX_STATS_SCOPE(m_stats, DrawBitmap);
+    FX_TRACE_SCOPE(Backend, "DrawBitmap");
+
+    std::visit([&](auto&& ctx) {
+        using T = std::decay_t<decltype(ctx)>;
+
+        if constexpr (std::is_same_v<T, wxGraphicsContext*>) {
+            if (ctx) {
+                const bool changed = interpolation != m_quality.interpolation;
+                if (changed) ctx->SetInterpolationQuality(interpolation);
+
+                // Large reductions: start from the nearest mip level
+                wxBitmap source = bitmap;
+                if (m_bitmapCache && interpolation != wxINTERPOLATION_NONE) {
+                    source = m_bitmapCache->GetMipLevel(bitmap, GetDeviceSize(w, h));
+                }
+                ctx->DrawBitmap(source, x, y, w, h);
+
+                if (changed) ctx->SetInterpolationQuality(m_quality.interpolation);
+            }
+        } else if constexpr (std::is_same_v<T, wxDC*>) {
+            if (ctx) {
+                const int iw = static_cast<int>(std::lround(w));
+                const int ih = static_cast<int>(std::lround(h));
+                if (iw <= 0 || ih <= 0) return;
+
+                if (iw == bitmap.GetWidth() && ih == bitmap.GetHeight()) {
+                    ctx->DrawBitmap(bitmap, wxCoord(x), wxCoord(y), true);
+                    return;
+                }
+
+                // wxDC can't scale on the fly: draw a scaled copy
+                wxImageResizeQuality quality = wxIMAGE_QUALITY_NORMAL;
+                switch (interpolation) {
+                case wxINTERPOLATION_NONE:
+                case wxINTERPOLATION_FAST: quality = wxIMAGE_QUALITY_NEAREST; break;
+                case wxINTERPOLATION_BEST: quality = wxIMAGE_QUALITY_HIGH;    break;
+                default: break;
+                }
+
+                if (m_bitmapCache) {
+                    ctx->DrawBitmap(m_bitmapCache->GetScaled(bitmap, wxSize(iw, ih), quality),
+                                    wxCoord(x), wxCoord(y), true);
+                } else if (quality == wxIMAGE_QUALITY_NEAREST) {
+                    // Nearest neighbour is what StretchBlit does anyway
+                    wxMemoryDC source;
+                    source.SelectObjectAsSource(bitmap);
+                    ctx->StretchBlit(wxCoord(x), wxCoord(y), iw, ih, &source,
+                                     0, 0, bitmap.GetWidth(), bitmap.GetHeight(), wxCOPY, true);
+                } else {
+                    wxImage scaled = bitmap.ConvertToImage().Scale(iw, ih, quality);
+                    FX_STATS_ADD(m_stats, nativeObjects, 1);
+                    FX_STATS_ADD(m_stats, bytesAllocated, size_t(iw) * ih * 4);
+                    ctx->DrawBitmap(wxBitmap(scaled), wxCoord(x), wxCoord(y), true);
+                }
+            }
+        }
+    }, m_context);
+}
+
+void fxDrawingContext::DrawImage(const wxImage& image, wxDouble x, wxDouble y, wxDouble w, wxDouble h)
+{
+    if (!image.IsOk()) return;
+
+    wxBitmap bitmap;
+    {
+        FX_TRACE_SCOPE(Encode, "ImageToBitmap");
+        bitmap = wxBitmap(image, 32);
+    }
+    DrawBitmap(bitmap, x, y, w, h);
+}
+
+//--------------------------------------
+// Recording
+//--------------------------------------
+void fxDrawingContext::BeginRecording(fxDisplayList* list)
+{
+    m_recorder = list;
+}
+
+void fxDrawingContext::EndRecording()
+{
+    m_recorder = nullptr;
+}
+
+//--------------------------------------
+// Render quality
+//--------------------------------------
+void fxDrawingContext::SetRenderQuality(const fxRenderQuality& quality)
+{
+    m_quality = quality;
+
+    // Applied to the target directly: recordings stay quality-neutral
+    std::visit([&](auto&& ctx){
+        using T = std::decay_t<decltype(ctx)>;
+        if constexpr (std::is_same_v<T, wxGraphicsContext*>)
+        {
+            if (ctx) {
+                ctx->SetAntialiasMode(quality.antialias);
+                ctx->SetInterpolationQuality(quality.interpolation);
+            }
+        }
+    }, m_context);
+}
+
+const fxGraphicsPath& fxDrawingContext::ForQuality(const fxGraphicsPath& path, fxGraphicsPath& storage) const
+{
+    const fxGraphicsPath* result = &path;
+
+    if (m_quality.decimationTolerance > 0.0 && path.GetPointCount() >= MIN_DECIMATION_POINTS) {
+        FX_TRACE_SCOPE(Path, "Decimate");
+        storage = path.Decimated(m_quality.decimationTolerance);
+        result = &storage;
+    }
+    if (m_quality.markerSimplifySize > 0.0 && result->HasMarkersBelow(m_quality.markerSimplifySize)) {
+        fxGraphicsPath simplified = result->WithSimplifiedMarkers(m_quality.markerSimplifySize);
+        storage = std::move(simplified);
+        result = &storage;
+    }
+    return *result;
+}
+
+void fxDrawingContext::SetQuality(fxQualityPreset preset)
+{
+    SetRenderQuality(fxRenderQuality::FromPreset(preset));
+}
+
+//--------------------------------------
+// Quality presets
+//--------------------------------------
+fxRenderQuality fxRenderQuality::FromPreset(fxQualityPreset preset)
+{
+    fxRenderQuality q;
+    switch (preset)
+    {
+    case fxQualityPreset::Draft:
+        q.antialias           = wxANTIALIAS_NONE;
+        q.flatteningTolerance = 1.5;
+        q.decimationTolerance = 1.0;
+        q.minTextHeight       = 6.0;   // unreadable anyway
+        q.markerSimplifySize  = 4.0;
+        q.interpolation       = wxINTERPOLATION_FAST;
+        break;
+
+    case fxQualityPreset::Normal:
+        q.antialias           = wxANTIALIAS_DEFAULT;
+        q.flatteningTolerance = 0.25;
+        q.interpolation       = wxINTERPOLATION_GOOD;
+        break;
+
+    case fxQualityPreset::Print:
+        q.antialias           = wxANTIALIAS_DEFAULT;
+        q.flatteningTolerance = 0.05;
+        q.interpolation       = wxINTERPOLATION_BEST;
+        break;
+    }
+    return q;
+}
+
+// Draft text: a bar of roughly the text size in the text colour.
+// The width is estimated from the font size, as measuring is part of the cost.
+void fxDrawingContext::DrawTextPlaceholder(const wxString& text, wxDouble x, wxDouble y, wxDouble angleRad)
+{
+    if (text.empty()) return;
+
+    const double h = GetFontHeight();
+    const double w = 0.55 * h * text.length();
+
+    // Text is anchored at its top-left corner and rotated counterclockwise
+    const double c = std::cos(angleRad), s = std::sin(angleRad);
+    const double mx = x + 0.5 * h * s, my = y + 0.5 * h * c;
+
+    // The backend pen may never have been set through this wrapper: a DC
+    // gets its own pen back, a GC the last one set here (or none)
+    const wxPen oldPen = m_pen;
+    wxPen dcPen;
+    if (auto dc = std::get_if<wxDC*>(&m_context); dc && *dc) dcPen = (*dc)->GetPen();
+
+    SetPen(wxPen(m_fontColour, std::max(1, int(h / 3))));
+    StrokeLine(mx, my, mx + w * c, my - w * s);
+
+    m_pen = oldPen;
+    std::visit([&](auto&& ctx) {
+        using T = std::decay_t<decltype(ctx)>;
+        if constexpr (std::is_same_v<T, wxGraphicsContext*>) {
+            if (ctx) ctx->SetPen(oldPen);
+        } else if constexpr (std::is_same_v<T, wxDC*>) {
+            if (ctx) ctx->SetPen(dcPen);
+        }
+    }, m_context);
+}
+
+double fxDrawingContext::GetFontHeight() const
+{
+    if (!m_font.IsOk()) return 12.0;
+    if (m_font.GetPixelSize().GetHeight() > 0) return m_font.GetPixelSize().GetHeight();
+    return 1.33 * m_font.GetFractionalPointSize();  // 96 dpi
+}
+
+#ifdef FX_RENDER_STATS
+//--------------------------------------
+// Instrumentation
+//--------------------------------------
+void fxDrawingContext::AddPathStats(const fxGraphicsPath& original, const fxGraphicsPath& drawn)
+{
+    const size_t vertices = CountFlattenedVertices(drawn, m_quality.flatteningTolerance);
+    m_stats.vertices += vertices;
+
+    // Decimated or simplified copy
+    if (&drawn != &original) {
+        m_stats.bytesAllocated += drawn.GetSegments().size() * sizeof(fxPathSegment);
+    }
+
+    if (IsGC()) {
+        // Native path rebuilt for this GC
+        if (drawn.GetContext() != std::get<wxGraphicsContext*>(m_context)) ++m_stats.nativeObjects;
+    } else {
+        // Point buffers of the DC fallback
+        m_stats.bytesAllocated += vertices * sizeof(wxPoint);
+    }
+}
+#endif // FX_RENDER_STATS
@@ -11,6 +11,34 @@
 #include <wx/dcsvg.h>
 #include <vector>
 #include "fxGraphicsPath.hpp"  // the fxGraphicsPath definition
+#include "fxPathView.hpp"
+#include "fxRenderStats.hpp"
+#include "fxBitmapCache.hpp"
+
+class fxDisplayList;
+
+// Named quality presets
+enum class fxQualityPreset
+{
+    Draft = 0,  // thumbnails, previews: fast over pretty
+    Normal,     // screen rendering
+    Print       // exports and printing: accuracy over speed
+};
+
+// Rendering quality knobs, applied to every backend where they make sense.
+// Text hinting follows the antialias mode on GC backends; wxDC offers no control.
+struct fxRenderQuality
+{
+    wxAntialiasMode antialias = wxANTIALIAS_DEFAULT;
+    double flatteningTolerance = 0.0;   // max curve deviation (px) on DC targets; 0 = fixed steps
+    double decimationTolerance = 0.0;   // drop path points closer than this (px); 0 = off
+    bool   placeholderText = false;     // draw text as bars instead of glyphs
+    double minTextHeight = 0.0;         // skip text with a smaller font height (px)
+    double markerSimplifySize = 0.0;    // circles/ellipses smaller than this (px) drawn as squares
+    wxInterpolationQuality interpolation = wxINTERPOLATION_DEFAULT;  // bitmap and gradient scaling
+
+    static fxRenderQuality FromPreset(fxQualityPreset preset);
+};
 
 enum class ExportFormat
 {
@@ -33,7 +61,10 @@ public:
 
     fxDrawingContext() = default;
     fxDrawingContext(wxGraphicsContext* gc);
-    fxDrawingContext(wxDC* dc);
+    // Window, memory and printer DCs are drawn through a wxGraphicsContext
+    // created on them unless createGC is false (e.g. to measure or check the
+    // plain wxDC paths); other DCs are always drawn directly
+    fxDrawingContext(wxDC* dc, bool createGC = true);
     ~fxDrawingContext() = default;  // no manual cleanup needed
 
     bool IsValid() const {
@@ -45,15 +76,33 @@ public:
     bool IsDC() const {
         return std::holds_alternative<wxDC*>(m_context);
     }
+    // True for pixel targets (bitmaps, windows); false for SVG, printers etc.
+    bool IsRasterTarget() const {
+        return IsValid() && !m_vectorTarget;
+    }
 
     // Get context size
     void GetSize(wxDouble* width, wxDouble* height) const;
     wxSize GetSize() const;
+
+    // Size in device pixels of a w x h user-space rectangle: through the
+    // current transform on GC targets (rounded up), as is on DC targets,
+    // which draw bitmaps unscaled by the user space
+    wxSize GetDeviceSize(wxDouble w, wxDouble h) const;
     
     // Appearance
     void Scale(wxDouble xScale, wxDouble yScale);
+    // On DC targets the mode is only remembered (returns false)
     bool SetAntialiasMode(wxAntialiasMode mode);
     wxAntialiasMode GetAntialiasMode() const;    
+
+    // Quality knobs for subsequent drawing calls.
+    // Recorded display lists keep full detail: quality applies on playback.
+    void SetRenderQuality(const fxRenderQuality& quality);
+    const fxRenderQuality& GetRenderQuality() const { return m_quality; }
+
+    // Shortcut for SetRenderQuality(fxRenderQuality::FromPreset(preset))
+    void SetQuality(fxQualityPreset preset);
     
     // Font settings
     void SetFont(const wxFont& font, const wxColour& colour = *wxBLACK); 
@@ -98,27 +147,96 @@ public:
     // On a real wxGraphicsContext, calls StrokePath(path).
     // On a raw wxDC, approximates a stroke from the path segments.
     void StrokePath(const fxGraphicsPath& path);    
+
+    // Same on an external polyline: the buffer is read directly (and
+    // decimated on the fly under the render quality), without building
+    // fxGraphicsPath segments. Recording copies it into the display list.
+    void DrawPath(const fxPathView& view);
+    void FillPath(const fxPathView& view, wxPolygonFillMode fillStyle = wxODDEVEN_RULE);
+    void StrokePath(const fxPathView& view);
+
+    // Draws a bitmap scaled into the given rectangle, with the interpolation
+    // of the render quality or the one given.
+    // With a bitmap cache set, reductions by 2x or more draw a cached mip
+    // level on GC targets and DC targets draw a cached copy scaled to the
+    // device size; without one, every draw scales the bitmap again.
+    void DrawBitmap(const wxBitmap& bitmap, wxDouble x, wxDouble y, wxDouble w, wxDouble h);
+    void DrawBitmap(const wxBitmap& bitmap, wxDouble x, wxDouble y, wxDouble w, wxDouble h,
+                    wxInterpolationQuality interpolation);
+
+    // Converts an image rendered in memory (heatmap, density map) to a 32-bit
+    // bitmap and draws it into the rectangle
+    void DrawImage(const wxImage& image, wxDouble x, wxDouble y, wxDouble w, wxDouble h);
+
+    // Cache of scaled bitmaps (not owned; none by default). Worth it for
+    // bitmaps drawn unchanged at the same sizes frame after frame.
+    void SetBitmapCache(fxBitmapCache* cache) { m_bitmapCache = cache; }
+    fxBitmapCache* GetBitmapCache() const { return m_bitmapCache; }
+
+    // Recording: while a display list is attached, drawing calls are appended
+    // to it instead of reaching the target. Queries (size, text extents) still
+    // go to the target, and fonts are applied so that measurements stay right.
+    void BeginRecording(fxDisplayList* list);
+    void EndRecording();
+    bool IsRecording() const { return m_recorder != nullptr; }
     
     // Access to underlying variant (optional, if you need it)
     const ContextVariant& GetVariant() const { return m_context; }
 
     // Flush the context if supported (e.g., for buffered drawing)
     void Flush();
+
+#ifdef FX_RENDER_STATS
+    // Per-call counters since the last reset
+    const fxRenderStats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats.Reset(); }
+#endif
     
 private:
     ContextVariant m_context;
     // We only need one newly created GC for the entire lifetime:
     std::shared_ptr<wxGraphicsContext> m_ownedGC;
+    // Target does not map to pixels (SVG file, printer)
+    bool m_vectorTarget = false;
+    // Active recorder, if any (not owned)
+    fxDisplayList* m_recorder = nullptr;
+
+    fxRenderQuality m_quality;
+    fxBitmapCache*  m_bitmapCache = nullptr;
+
+#ifdef FX_RENDER_STATS
+    // Instrumentation (mutable: queries are counted too)
+    mutable fxRenderStats m_stats;
+    void AddPathStats(const fxGraphicsPath& original, const fxGraphicsPath& drawn);
+#endif
+
+    // Last state set through this wrapper
+    wxPen    m_pen;
+    wxBrush  m_brush;
+    wxFont   m_font;
+    wxColour m_fontColour = *wxBLACK;
+
+    // Path to draw under the current quality (decimated copy in storage, or path itself)
+    const fxGraphicsPath& ForQuality(const fxGraphicsPath& path, fxGraphicsPath& storage) const;
+
+    enum class ViewOp { Draw, Fill, Stroke };
+    void RenderView(const fxPathView& view, ViewOp op, wxPolygonFillMode fillStyle);
+    void DrawTextPlaceholder(const wxString& text, wxDouble x, wxDouble y, wxDouble angleRad);
+    // Approximate pixel height of the current font
+    double GetFontHeight() const;
 };
 
 // Draw path fallback for wxDC
-void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMode = wxODDEVEN_RULE);
+// (curves are flattened within tolerance pixels; 0 = fixed step count)
+void DrawPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillMode = wxODDEVEN_RULE,
+                  double tolerance = 0.0);
 
 // Fallback helper to fill on a DC
-void FillPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillStyle = wxODDEVEN_RULE);
+void FillPathOnDC(wxDC* dc, const fxGraphicsPath& path, wxPolygonFillMode fillStyle = wxODDEVEN_RULE,
+                  double tolerance = 0.0);
 
 // Fallback helper to stroke on a DC
-void StrokePathOnDC(wxDC* dc, const fxGraphicsPath& path);
+void StrokePathOnDC(wxDC* dc, const fxGraphicsPath& path, double tolerance = 0.0);
 
 
 #endif // FXDRAWINGCONTEXT_HPP
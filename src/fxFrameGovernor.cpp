@@ -0,0 +1,114 @@
+// fxFrameGovernor.cpp
+#include "fxFrameGovernor.hpp"
+#include <algorithm>
+
+namespace {
+// Exponential smoothing of the frame time
+const double SMOOTHING = 0.3;
+// Degrade above this fraction of the target...
+const double DEGRADE_RATIO = 0.95;
+// ...and restore only below this one, so a restored level has room to fit
+const double RESTORE_RATIO = 0.5;
+}
+
+fxFrameGovernor::fxFrameGovernor(double targetFrameMs)
+    : m_levels(DefaultLevels()), m_targetMs(targetFrameMs)
+{
+}
+
+std::vector<fxRenderQuality> fxFrameGovernor::DefaultLevels()
+{
+    std::vector<fxRenderQuality> levels(5);
+
+    // 0: full quality (defaults)
+
+    // 1: sub-pixel decimation, invisible at screen resolution
+    levels[1].decimationTolerance = 0.5;
+
+    // 2: coarser curves and decimation
+    levels[2].flatteningTolerance = 1.0;
+    levels[2].decimationTolerance = 1.0;
+
+    // 3: no antialiasing, small labels dropped
+    levels[3].antialias           = wxANTIALIAS_NONE;
+    levels[3].flatteningTolerance = 2.0;
+    levels[3].decimationTolerance = 2.0;
+    levels[3].minTextHeight       = 10.0;
+
+    // 4: survival mode
+    levels[4].antialias           = wxANTIALIAS_NONE;
+    levels[4].flatteningTolerance = 4.0;
+    levels[4].decimationTolerance = 4.0;
+    levels[4].minTextHeight       = 16.0;
+
+    return levels;
+}
+
+void fxFrameGovernor::SetLevels(const std::vector<fxRenderQuality>& levels)
+{
+    m_levels = levels.empty() ? DefaultLevels() : levels;
+    Reset();
+}
+
+void fxFrameGovernor::Reset()
+{
+    m_level = 0;
+    m_lastMs = 0.0;
+    m_smoothedMs = -1.0;
+    m_headroomFrames = 0;
+}
+
+//--------------------------------------
+// Frame bracketing
+//--------------------------------------
+void fxFrameGovernor::BeginFrame(fxDrawingContext& ctx)
+{
+    ctx.SetRenderQuality(m_levels[m_level]);
+    m_traceStart = FX_TRACE_NOW();
+    m_clock.Start();
+}
+
+void fxFrameGovernor::EndFrame(fxDrawingContext& ctx)
+{
+    // Include the native flush in the measurement
+    ctx.Flush();
+    m_lastMs = m_clock.TimeInMicro().GetValue() / 1000.0;
+    FX_TRACE_RECORD(Frame, "Frame", m_traceStart);
+    Adapt(m_lastMs);
+}
+
+//--------------------------------------
+// Level control
+//--------------------------------------
+void fxFrameGovernor::Adapt(double frameMs)
+{
+    m_smoothedMs = m_smoothedMs < 0.0 ? frameMs
+                                      : SMOOTHING * frameMs + (1.0 - SMOOTHING) * m_smoothedMs;
+
+    if (m_smoothedMs > DEGRADE_RATIO * m_targetMs)
+    {
+        // A single very slow frame may need several steps at once
+        size_t level = m_level + 1;
+        if (frameMs > 2.0 * m_targetMs) level = m_level + 2;
+        ChangeLevel(std::min(level, m_levels.size() - 1));
+        return;
+    }
+
+    if (m_level > 0 && m_smoothedMs < RESTORE_RATIO * m_targetMs)
+    {
+        if (++m_headroomFrames >= m_restoreFrames) {
+            ChangeLevel(m_level - 1);
+        }
+    }
+    else {
+        m_headroomFrames = 0;
+    }
+}
+
+void fxFrameGovernor::ChangeLevel(size_t level)
+{
+    if (level == m_level) return;
+    m_level = level;
+    m_smoothedMs = -1.0;  // timings of the old level no longer apply
+    m_headroomFrames = 0;
+}
@@ -0,0 +1,63 @@
+// fxFrameGovernor.hpp
+
+#ifndef FXFRAMEGOVERNOR_HPP
+#define FXFRAMEGOVERNOR_HPP
+
+#include <vector>
+#include <wx/stopwatch.h>
+#include "fxDrawingContext.hpp"
+#include "fxTrace.hpp"
+
+// Frame time governor with automatic level of detail.
+// Frames are bracketed by BeginFrame()/EndFrame() on the drawing context;
+// the governor measures their duration and walks a ladder of render
+// qualities (level 0 = best) to stay within the target frame time:
+// it degrades as soon as the smoothed frame time exceeds the target, and
+// restores quality one level at a time after a run of frames with enough
+// headroom.
+class fxFrameGovernor
+{
+public:
+    explicit fxFrameGovernor(double targetFrameMs = 1000.0 / 30.0);
+
+    void SetTargetFrameTime(double ms) { m_targetMs = ms; }
+    double GetTargetFrameTime() const { return m_targetMs; }
+
+    // Quality ladder, best first
+    void SetLevels(const std::vector<fxRenderQuality>& levels);
+    const std::vector<fxRenderQuality>& GetLevels() const { return m_levels; }
+    static std::vector<fxRenderQuality> DefaultLevels();
+
+    // Frames in a row below the restore threshold before quality goes up
+    void SetRestoreFrames(int frames) { m_restoreFrames = frames; }
+
+    // Apply the current level to ctx and start timing
+    void BeginFrame(fxDrawingContext& ctx);
+    // Flush ctx, stop timing and adapt the level
+    void EndFrame(fxDrawingContext& ctx);
+
+    size_t GetLevel() const { return m_level; }
+    const fxRenderQuality& GetQuality() const { return m_levels[m_level]; }
+    double GetLastFrameTime() const { return m_lastMs; }
+    double GetSmoothedFrameTime() const { return m_smoothedMs; }
+
+    // Back to best quality, forget the history
+    void Reset();
+
+private:
+    std::vector<fxRenderQuality> m_levels;
+    double m_targetMs;
+    size_t m_level = 0;
+
+    wxStopWatch m_clock;
+    int64_t m_traceStart = -1;    // frame start on the trace timeline
+    double m_lastMs = 0.0;
+    double m_smoothedMs = -1.0;   // < 0: no sample since last level change
+    int    m_headroomFrames = 0;
+    int    m_restoreFrames = 15;
+
+    void Adapt(double frameMs);
+    void ChangeLevel(size_t level);
+};
+
+#endif // FXFRAMEGOVERNOR_HPP
@@ -2,6 +2,8 @@
 #include <cmath>
 #include <vector>
 #include <wx/gdicmn.h> 
+#include <utility>
+#include <algorithm>
 
 
 // Approximate a circular arc from angleStart to angleEnd (radians) around center (cx,cy), radius r.
@@ -72,3 +74,550 @@ std::vector<wxPoint2DDouble> ApproxCubicBezier(wxPoint2DDouble p0, wxPoint2DDoub
     return pts;
 }
 
+
+
+// Replay the tracked segments into a native path, e.g. when a path recorded
+// on one context (or on none) has to be drawn on another wxGraphicsContext.
+void fxGraphicsPath::BuildNativePath(wxGraphicsPath& path, const std::vector<fxPathSegment>& segments)
+{
+    for (const auto& seg : segments)
+    {
+        const auto& p = seg.points;
+        switch (seg.type)
+        {
+        case fxPathSegmentType::MoveTo:
+            if (!p.empty()) path.MoveToPoint(p[0].m_x, p[0].m_y);
+            break;
+        case fxPathSegmentType::LineTo:
+            if (!p.empty()) path.AddLineToPoint(p[0].m_x, p[0].m_y);
+            break;
+        case fxPathSegmentType::Polyline:
+            for (const auto& pt : p) path.AddLineToPoint(pt.m_x, pt.m_y);
+            break;
+        case fxPathSegmentType::QuadCurveTo:
+            if (p.size() >= 2) path.AddQuadCurveToPoint(p[0].m_x, p[0].m_y, p[1].m_x, p[1].m_y);
+            break;
+        case fxPathSegmentType::CurveTo:
+            if (p.size() >= 3) path.AddCurveToPoint(p[0].m_x, p[0].m_y, p[1].m_x, p[1].m_y, p[2].m_x, p[2].m_y);
+            break;
+        case fxPathSegmentType::Arc:
+            if (!p.empty()) path.AddArc(p[0].m_x, p[0].m_y, seg.radius, seg.startAngle, seg.endAngle, seg.clockwise);
+            break;
+        case fxPathSegmentType::ArcTo:
+            if (p.size() >= 2) path.AddArcToPoint(p[0].m_x, p[0].m_y, p[1].m_x, p[1].m_y, seg.radius);
+            break;
+        case fxPathSegmentType::Rectangle:
+            if (p.size() >= 2) path.AddRectangle(p[0].m_x, p[0].m_y, p[1].m_x - p[0].m_x, p[1].m_y - p[0].m_y);
+            break;
+        case fxPathSegmentType::RoundedRectangle:
+            if (p.size() >= 2) path.AddRoundedRectangle(p[0].m_x, p[0].m_y, p[1].m_x - p[0].m_x, p[1].m_y - p[0].m_y, seg.radius);
+            break;
+        case fxPathSegmentType::Ellipse:
+            // (center, radius) for circles, bounding corners for ellipses
+            if (p.size() == 1) path.AddCircle(p[0].m_x, p[0].m_y, seg.radius);
+            else if (p.size() >= 2) path.AddEllipse(p[0].m_x, p[0].m_y, p[1].m_x - p[0].m_x, p[1].m_y - p[0].m_y);
+            break;
+        case fxPathSegmentType::Close:
+            path.CloseSubpath();
+            break;
+        }
+    }
+}
+
+
+// Lowering of shapes that an affine matrix would distort into lines and
+// cubic Beziers, with the arc conventions of wxGraphicsPath (angles grow
+// clockwise on screen; AddArc(clockwise = true) sweeps them upwards)
+namespace {
+
+using Segments = std::vector<fxPathSegment>;
+
+wxPoint2DDouble OnCircle(const wxPoint2DDouble& c, double rx, double ry, double angle)
+{
+    return wxPoint2DDouble(c.m_x + rx * std::cos(angle), c.m_y + ry * std::sin(angle));
+}
+
+// Cubic pieces of an elliptical arc, at most a quarter turn each
+void AppendArcCurves(Segments& out, const wxPoint2DDouble& c, double rx, double ry, double start, double sweep)
+{
+    const int pieces = std::max(1, static_cast<int>(std::ceil(std::abs(sweep) / (M_PI / 2) - 1e-9)));
+    const double step = sweep / pieces;
+    const double k = 4.0 / 3.0 * std::tan(step / 4);
+
+    for (int i = 0; i < pieces; ++i) {
+        const double a = start + i * step;
+        const double b = a + step;
+        const wxPoint2DDouble p0 = OnCircle(c, rx, ry, a);
+        const wxPoint2DDouble p3 = OnCircle(c, rx, ry, b);
+        const wxPoint2DDouble c1(p0.m_x - k * rx * std::sin(a), p0.m_y + k * ry * std::cos(a));
+        const wxPoint2DDouble c2(p3.m_x + k * rx * std::sin(b), p3.m_y - k * ry * std::cos(b));
+        out.push_back({fxPathSegmentType::CurveTo, {c1, c2, p3}});
+    }
+}
+
+// Sweep of AddArc from start to end
+double ArcSweep(double start, double end, bool clockwise)
+{
+    double sweep = end - start;
+    if (clockwise || sweep >= 2 * M_PI) {
+        while (sweep < 0.0) sweep += 2 * M_PI;
+    } else {
+        while (sweep > 0.0) sweep -= 2 * M_PI;
+    }
+    return sweep;
+}
+
+// Tangent arc of AddArcToPoint: from p0 towards p1, then towards p2
+struct TangentArc
+{
+    wxPoint2DDouble from, to, center;
+    double start = 0.0;
+    double sweep = 0.0;
+};
+
+bool GetTangentArc(const wxPoint2DDouble& p0, const wxPoint2DDouble& p1, const wxPoint2DDouble& p2,
+                   double radius, TangentArc& arc)
+{
+    const double l0 = std::hypot(p0.m_x - p1.m_x, p0.m_y - p1.m_y);
+    const double l2 = std::hypot(p2.m_x - p1.m_x, p2.m_y - p1.m_y);
+    if (!(radius > 0.0) || l0 == 0.0 || l2 == 0.0) return false;
+
+    const wxPoint2DDouble u0((p0.m_x - p1.m_x) / l0, (p0.m_y - p1.m_y) / l0);
+    const wxPoint2DDouble u2((p2.m_x - p1.m_x) / l2, (p2.m_y - p1.m_y) / l2);
+    const double angle = std::acos(std::clamp(u0.m_x * u2.m_x + u0.m_y * u2.m_y, -1.0, 1.0));
+    if (angle < 1e-9 || M_PI - angle < 1e-9) return false;    // collinear
+
+    const double along = radius / std::tan(angle / 2);
+    const double toCenter = radius / std::sin(angle / 2);
+    const double bl = std::hypot(u0.m_x + u2.m_x, u0.m_y + u2.m_y);
+
+    arc.from   = wxPoint2DDouble(p1.m_x + u0.m_x * along, p1.m_y + u0.m_y * along);
+    arc.to     = wxPoint2DDouble(p1.m_x + u2.m_x * along, p1.m_y + u2.m_y * along);
+    arc.center = wxPoint2DDouble(p1.m_x + (u0.m_x + u2.m_x) / bl * toCenter,
+                                 p1.m_y + (u0.m_y + u2.m_y) / bl * toCenter);
+    arc.start  = std::atan2(arc.from.m_y - arc.center.m_y, arc.from.m_x - arc.center.m_x);
+
+    // The short way round
+    double sweep = std::atan2(arc.to.m_y - arc.center.m_y, arc.to.m_x - arc.center.m_x) - arc.start;
+    if (sweep > M_PI) sweep -= 2 * M_PI;
+    else if (sweep < -M_PI) sweep += 2 * M_PI;
+    arc.sweep = sweep;
+    return true;
+}
+
+// Current point while walking the segments
+struct PathCursor
+{
+    wxPoint2DDouble point;
+    wxPoint2DDouble subpathStart;
+    bool            valid = false;
+
+    void MoveTo(const wxPoint2DDouble& p) { point = subpathStart = p; valid = true; }
+    void LineTo(const wxPoint2DDouble& p) { if (!valid) subpathStart = p; point = p; valid = true; }
+};
+
+// Same geometry as seg, in MoveTo/LineTo/CurveTo/Close segments
+void LowerSegment(const fxPathSegment& seg, const PathCursor& cursor, Segments& out)
+{
+    const auto& p = seg.points;
+    const auto moveOrLine = [&](const wxPoint2DDouble& q) {
+        out.push_back({cursor.valid ? fxPathSegmentType::LineTo : fxPathSegmentType::MoveTo, {q}});
+    };
+
+    switch (seg.type)
+    {
+    case fxPathSegmentType::Arc:
+        if (p.empty()) break;
+        moveOrLine(OnCircle(p[0], seg.radius, seg.radius, seg.startAngle));
+        AppendArcCurves(out, p[0], seg.radius, seg.radius, seg.startAngle,
+                        ArcSweep(seg.startAngle, seg.endAngle, seg.clockwise));
+        break;
+
+    case fxPathSegmentType::ArcTo:
+    {
+        if (p.size() < 2) break;
+        TangentArc arc;
+        if (!cursor.valid || !GetTangentArc(cursor.point, p[0], p[1], seg.radius, arc)) {
+            moveOrLine(p[0]);
+            break;
+        }
+        out.push_back({fxPathSegmentType::LineTo, {arc.from}});
+        AppendArcCurves(out, arc.center, seg.radius, seg.radius, arc.start, arc.sweep);
+        break;
+    }
+
+    case fxPathSegmentType::Rectangle:
+        if (p.size() < 2) break;
+        out.push_back({fxPathSegmentType::MoveTo, {p[0]}});
+        out.push_back({fxPathSegmentType::Polyline, {{p[1].m_x, p[0].m_y}, p[1], {p[0].m_x, p[1].m_y}}});
+        out.push_back({fxPathSegmentType::Close, {}});
+        break;
+
+    case fxPathSegmentType::RoundedRectangle:
+    {
+        if (p.size() < 2) break;
+        const double x1 = std::min(p[0].m_x, p[1].m_x), x2 = std::max(p[0].m_x, p[1].m_x);
+        const double y1 = std::min(p[0].m_y, p[1].m_y), y2 = std::max(p[0].m_y, p[1].m_y);
+        const double r = std::min(seg.radius, 0.5 * std::min(x2 - x1, y2 - y1));
+        if (!(r > 0.0)) {
+            LowerSegment({fxPathSegmentType::Rectangle, {p[0], p[1]}}, cursor, out);
+            break;
+        }
+        out.push_back({fxPathSegmentType::MoveTo, {{x2, y2 - r}}});
+        AppendArcCurves(out, {x2 - r, y2 - r}, r, r, 0.0, M_PI / 2);
+        out.push_back({fxPathSegmentType::LineTo, {{x1 + r, y2}}});
+        AppendArcCurves(out, {x1 + r, y2 - r}, r, r, M_PI / 2, M_PI / 2);
+        out.push_back({fxPathSegmentType::LineTo, {{x1, y1 + r}}});
+        AppendArcCurves(out, {x1 + r, y1 + r}, r, r, M_PI, M_PI / 2);
+        out.push_back({fxPathSegmentType::LineTo, {{x2 - r, y1}}});
+        AppendArcCurves(out, {x2 - r, y1 + r}, r, r, 1.5 * M_PI, M_PI / 2);
+        out.push_back({fxPathSegmentType::Close, {}});
+        break;
+    }
+
+    case fxPathSegmentType::Ellipse:
+    {
+        // (center, radius) for circles, bounding corners for ellipses
+        wxPoint2DDouble c;
+        double rx = 0.0, ry = 0.0;
+        if (p.size() == 1) {
+            c = p[0];
+            rx = ry = seg.radius;
+        } else if (p.size() >= 2) {
+            c = wxPoint2DDouble(0.5 * (p[0].m_x + p[1].m_x), 0.5 * (p[0].m_y + p[1].m_y));
+            rx = 0.5 * std::abs(p[1].m_x - p[0].m_x);
+            ry = 0.5 * std::abs(p[1].m_y - p[0].m_y);
+        } else {
+            break;
+        }
+        out.push_back({fxPathSegmentType::MoveTo, {OnCircle(c, rx, ry, 0.0)}});
+        AppendArcCurves(out, c, rx, ry, 0.0, 2 * M_PI);
+        out.push_back({fxPathSegmentType::Close, {}});
+        break;
+    }
+
+    default:
+        out.push_back(seg);
+        break;
+    }
+}
+
+// Current point after seg
+void Advance(PathCursor& cursor, const fxPathSegment& seg)
+{
+    const auto& p = seg.points;
+    switch (seg.type)
+    {
+    case fxPathSegmentType::MoveTo:
+        if (!p.empty()) cursor.MoveTo(p[0]);
+        break;
+    case fxPathSegmentType::LineTo:
+    case fxPathSegmentType::Polyline:
+    case fxPathSegmentType::QuadCurveTo:
+    case fxPathSegmentType::CurveTo:
+        if (!p.empty()) cursor.LineTo(p.back());
+        break;
+    case fxPathSegmentType::Arc:
+        if (!p.empty()) {
+            const double end = seg.startAngle + ArcSweep(seg.startAngle, seg.endAngle, seg.clockwise);
+            cursor.LineTo(OnCircle(p[0], seg.radius, seg.radius, end));
+        }
+        break;
+    case fxPathSegmentType::ArcTo:
+        if (p.size() >= 2) {
+            TangentArc arc;
+            cursor.LineTo(cursor.valid && GetTangentArc(cursor.point, p[0], p[1], seg.radius, arc) ? arc.to : p[0]);
+        }
+        break;
+    case fxPathSegmentType::Rectangle:
+    case fxPathSegmentType::RoundedRectangle:
+    case fxPathSegmentType::Ellipse:
+        // Closed shapes of their own
+        cursor.valid = false;
+        break;
+    case fxPathSegmentType::Close:
+        cursor.point = cursor.subpathStart;
+        break;
+    }
+}
+
+} // namespace
+
+
+// Transform the tracked geometry by an affine matrix; the native path, if
+// any, is rebuilt from the transformed segments. Shapes that would not keep
+// their kind (boxes under rotation or shear, circles and arcs under a
+// non-uniform scale) are lowered to lines and Beziers first.
+void fxGraphicsPath::Transform(const wxAffineMatrix2D& matrix)
+{
+    wxMatrix2D m;
+    wxPoint2DDouble t;
+    matrix.Get(&m, &t);
+
+    const double det      = m.m_11 * m.m_22 - m.m_12 * m.m_21;
+    const double scale    = std::sqrt(std::abs(det));
+    const double rotation = std::atan2(m.m_12, m.m_11);
+    const bool   mirrored = det < 0.0;
+
+    const double eps = 1e-12 * (std::abs(m.m_11) + std::abs(m.m_12) + std::abs(m.m_21) + std::abs(m.m_22));
+    const bool axisAligned = std::abs(m.m_12) <= eps && std::abs(m.m_21) <= eps;
+    const bool similarity  = mirrored ? std::abs(m.m_11 + m.m_22) <= eps && std::abs(m.m_12 - m.m_21) <= eps
+                                      : std::abs(m.m_11 - m.m_22) <= eps && std::abs(m.m_12 + m.m_21) <= eps;
+
+    const auto keepsShape = [&](const fxPathSegment& seg) {
+        switch (seg.type)
+        {
+        case fxPathSegmentType::Arc:
+        case fxPathSegmentType::ArcTo:            return similarity;
+        case fxPathSegmentType::Rectangle:        return axisAligned;
+        case fxPathSegmentType::RoundedRectangle: return axisAligned && similarity;
+        case fxPathSegmentType::Ellipse:          return seg.points.size() == 1 ? similarity : axisAligned;
+        default:                                  return true;
+        }
+    };
+
+    if (!std::all_of(m_segments.begin(), m_segments.end(), keepsShape)) {
+        Segments lowered;
+        lowered.reserve(m_segments.size());
+        PathCursor cursor;
+        for (const auto& seg : m_segments) {
+            if (keepsShape(seg)) lowered.push_back(seg);
+            else LowerSegment(seg, cursor, lowered);
+            Advance(cursor, seg);
+        }
+        m_segments = std::move(lowered);
+    }
+
+    for (auto& seg : m_segments)
+    {
+        for (auto& pt : seg.points) {
+            pt = matrix.TransformPoint(pt);
+        }
+
+        switch (seg.type)
+        {
+        case fxPathSegmentType::Arc:
+            seg.radius *= scale;
+            if (mirrored) {
+                seg.startAngle = -seg.startAngle;
+                seg.endAngle   = -seg.endAngle;
+                seg.clockwise  = !seg.clockwise;
+            }
+            seg.startAngle += rotation;
+            seg.endAngle   += rotation;
+            break;
+
+        case fxPathSegmentType::ArcTo:
+            seg.radius *= scale;
+            break;
+
+        case fxPathSegmentType::RoundedRectangle:
+            seg.radius *= scale;
+            [[fallthrough]];
+        case fxPathSegmentType::Rectangle:
+        case fxPathSegmentType::Ellipse:
+            if (seg.points.size() == 1) {
+                seg.radius *= scale;  // circle: center + radius
+            }
+            else if (seg.points.size() >= 2) {
+                // Boxes are axis aligned: keep (min, max) corners
+                auto& a = seg.points[0];
+                auto& b = seg.points[1];
+                if (a.m_x > b.m_x) std::swap(a.m_x, b.m_x);
+                if (a.m_y > b.m_y) std::swap(a.m_y, b.m_y);
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    if (m_gc) {
+        m_path = m_gc->CreatePath();
+        BuildNativePath(m_path, m_segments);
+    }
+}
+
+
+// Flattening step counts for a given tolerance
+namespace {
+const int MAX_FLATTENING_STEPS = 1024;
+
+int ClampSteps(double steps)
+{
+    if (!(steps >= 1.0)) return 1;
+    return steps > MAX_FLATTENING_STEPS ? MAX_FLATTENING_STEPS : static_cast<int>(std::ceil(steps));
+}
+
+double Norm(const wxPoint2DDouble& p)
+{
+    return std::sqrt(p.m_x * p.m_x + p.m_y * p.m_y);
+}
+} // namespace
+
+// A chord spanning angle a deviates r * (1 - cos(a/2)) from the arc
+int ArcSteps(double radius, double sweepAngle, double tolerance, int defaultSteps)
+{
+    if (tolerance <= 0.0) return defaultSteps;
+    radius = std::abs(radius);
+    if (tolerance >= radius) return 1;
+
+    const double maxAngle = 2.0 * std::acos(1.0 - tolerance / radius);
+    return ClampSteps(std::abs(sweepAngle) / maxAngle);
+}
+
+// Wang's formula: n = sqrt(d(d-1)/8 * M / tolerance), M = max second difference
+int QuadBezierSteps(wxPoint2DDouble p0, wxPoint2DDouble c, wxPoint2DDouble p1, double tolerance, int defaultSteps)
+{
+    if (tolerance <= 0.0) return defaultSteps;
+    const double m = Norm(p0 - c * 2.0 + p1);
+    return ClampSteps(std::sqrt(0.25 * m / tolerance));
+}
+
+int CubicBezierSteps(wxPoint2DDouble p0, wxPoint2DDouble c1, wxPoint2DDouble c2, wxPoint2DDouble p1, double tolerance, int defaultSteps)
+{
+    if (tolerance <= 0.0) return defaultSteps;
+    const double m = std::max(Norm(p0 - c1 * 2.0 + c2), Norm(c1 - c2 * 2.0 + p1));
+    return ClampSteps(std::sqrt(0.75 * m / tolerance));
+}
+
+// Radial-distance decimation of LineTo runs
+fxGraphicsPath fxGraphicsPath::Decimated(double tolerance) const
+{
+    fxGraphicsPath out;
+    if (tolerance <= 0.0) {
+        out.m_segments = m_segments;
+        return out;
+    }
+
+    const double tol2 = tolerance * tolerance;
+    out.m_segments.reserve(m_segments.size());
+
+    wxPoint2DDouble kept;
+    bool haveKept = false;
+
+    for (size_t i = 0; i < m_segments.size(); ++i)
+    {
+        const auto& seg = m_segments[i];
+        if (seg.type == fxPathSegmentType::Polyline && !seg.points.empty())
+        {
+            // Same rule inside the segment; its last point ends the run
+            std::vector<wxPoint2DDouble> points;
+            for (size_t k = 0; k < seg.points.size(); ++k) {
+                const auto& pt = seg.points[k];
+                const double dx = pt.m_x - kept.m_x;
+                const double dy = pt.m_y - kept.m_y;
+                if (haveKept && k + 1 < seg.points.size() && dx * dx + dy * dy < tol2) continue;
+                points.push_back(pt);
+                kept = pt;
+                haveKept = true;
+            }
+            out.m_segments.push_back({fxPathSegmentType::Polyline, std::move(points)});
+            continue;
+        }
+        if (seg.type == fxPathSegmentType::LineTo && haveKept && !seg.points.empty())
+        {
+            const bool lastOfRun = i + 1 == m_segments.size() ||
+                                   m_segments[i + 1].type != fxPathSegmentType::LineTo;
+            const double dx = seg.points[0].m_x - kept.m_x;
+            const double dy = seg.points[0].m_y - kept.m_y;
+            if (!lastOfRun && dx * dx + dy * dy < tol2) continue;
+        }
+
+        out.m_segments.push_back(seg);
+        if (!seg.points.empty()) {
+            kept = seg.points.back();
+            haveKept = true;
+        }
+    }
+    return out;
+}
+
+// Mirrors the flattening done by DrawPathOnDC
+size_t CountFlattenedVertices(const fxGraphicsPath& path, double tolerance)
+{
+    size_t count = 0;
+    wxPoint2DDouble lastPt(0, 0);
+
+    for (const auto& seg : path.GetSegments())
+    {
+        const auto& p = seg.points;
+        switch (seg.type)
+        {
+        case fxPathSegmentType::QuadCurveTo:
+            if (p.size() >= 2) count += QuadBezierSteps(lastPt, p[0], p[1], tolerance);
+            break;
+        case fxPathSegmentType::CurveTo:
+            if (p.size() >= 3) count += CubicBezierSteps(lastPt, p[0], p[1], p[2], tolerance);
+            break;
+        case fxPathSegmentType::Arc:
+            count += ArcSteps(seg.radius, seg.endAngle - seg.startAngle, tolerance) + 1;
+            break;
+        case fxPathSegmentType::RoundedRectangle:
+            count += 4 * (ArcSteps(seg.radius, M_PI / 2, tolerance, 6) + 1);
+            break;
+        case fxPathSegmentType::Rectangle:
+            count += 4;
+            break;
+        case fxPathSegmentType::Ellipse:
+            {
+                const double r = p.size() == 1 ? seg.radius
+                               : p.size() >= 2 ? 0.25 * (std::abs(p[1].m_x - p[0].m_x) + std::abs(p[1].m_y - p[0].m_y))
+                               : 0.0;
+                count += ArcSteps(r, 2 * M_PI, tolerance, 24);
+            }
+            break;
+        case fxPathSegmentType::Close:
+            break;
+        default:
+            count += p.size();
+            break;
+        }
+        if (!p.empty()) lastPt = p.back();
+    }
+    return count;
+}
+
+// Size of an Ellipse segment (circle: center + radius, ellipse: corners)
+namespace {
+wxPoint2DDouble EllipseSize(const fxPathSegment& seg)
+{
+    if (seg.points.size() == 1) return {2 * seg.radius, 2 * seg.radius};
+    if (seg.points.size() >= 2) return {std::abs(seg.points[1].m_x - seg.points[0].m_x),
+                                        std::abs(seg.points[1].m_y - seg.points[0].m_y)};
+    return {0, 0};
+}
+} // namespace
+
+bool fxGraphicsPath::HasMarkersBelow(double size) const
+{
+    for (const auto& seg : m_segments) {
+        if (seg.type != fxPathSegmentType::Ellipse) continue;
+        const auto s = EllipseSize(seg);
+        if (s.m_x < size && s.m_y < size) return true;
+    }
+    return false;
+}
+
+fxGraphicsPath fxGraphicsPath::WithSimplifiedMarkers(double size) const
+{
+    fxGraphicsPath out;
+    out.m_segments = m_segments;
+
+    for (auto& seg : out.m_segments)
+    {
+        if (seg.type != fxPathSegmentType::Ellipse) continue;
+        const auto s = EllipseSize(seg);
+        if (s.m_x >= size || s.m_y >= size) continue;
+
+        if (seg.points.size() == 1) {
+            const auto c = seg.points[0];
+            const double r = seg.radius;
+            seg.points = {{c.m_x - r, c.m_y - r}, {c.m_x + r, c.m_y + r}};
+        }
+        seg.type = fxPathSegmentType::Rectangle;
+        seg.radius = 0.0;
+    }
+    return out;
+}
@@ -2,6 +2,7 @@
 #define FXGRAPHICSPATH_HPP
 
 #include <wx/graphics.h>
+#include <wx/affinematrix2d.h>
 #include <vector>
 #include <cmath>
 
@@ -16,7 +17,8 @@ enum class fxPathSegmentType {
     Rectangle,
     RoundedRectangle,
     Ellipse,
-    Close
+    Close,
+    Polyline        // LineTo through each point in turn
 };
 
 struct fxPathSegment {
@@ -51,6 +53,17 @@ public:
         }
     }
 
+    // Rebind the geometry of another path to a (possibly different) GC.
+    // The native wxGraphicsPath is rebuilt from the tracked segments.
+    fxGraphicsPath(wxGraphicsContext* gc, const fxGraphicsPath& other)
+        : m_gc(gc), m_segments(other.m_segments)
+    {
+        if (m_gc) {
+            m_path = m_gc->CreatePath();
+            BuildNativePath(m_path, m_segments);
+        }
+    }
+
     //================================================
     // 1) MoveTo
     //================================================
@@ -85,6 +98,22 @@ public:
         AddLineToPoint(p.m_x, p.m_y);
     }
 
+    // Many LineTo as one segment: a single point vector instead of one
+    // segment per point. The vector is taken over without copying.
+    void AddPolyline(std::vector<wxPoint2DDouble>&& points)
+    {
+        if (points.empty()) return;
+        if (m_gc) {
+            for (const auto& p : points) m_path.AddLineToPoint(p.m_x, p.m_y);
+        }
+        m_segments.push_back({fxPathSegmentType::Polyline, std::move(points)});
+    }
+
+    void AddPolyline(const wxPoint2DDouble* points, size_t n)
+    {
+        AddPolyline(std::vector<wxPoint2DDouble>(points, points + n));
+    }
+
     //================================================
     // 3) Cubic bezier
     //================================================
@@ -232,6 +261,11 @@ public:
         }
     }
 
+    // Transform by a GC-independent matrix (e.g. a scene node transform).
+    // Boxes under rotation or shear, and circles and arcs under non-uniform
+    // scaling, become line and curve segments.
+    void Transform(const wxAffineMatrix2D& matrix);
+
     //================================================
     // 14) Box, current point, Contains
     //================================================
@@ -316,13 +350,49 @@ public:
     const wxGraphicsPath& GetPath() const { return m_path; }
     wxGraphicsContext*    GetContext() const { return m_gc; }
 
+    // Native path usable on the given GC: our own when it was built there,
+    // otherwise a fresh one rebuilt from the tracked segments.
+    wxGraphicsPath GetPathFor(wxGraphicsContext* gc) const
+    {
+        if (!gc || gc == m_gc) {
+            return m_path;
+        }
+        wxGraphicsPath path = gc->CreatePath();
+        BuildNativePath(path, m_segments);
+        return path;
+    }
+
     const std::vector<fxPathSegment>& GetSegments() const { return m_segments; }
 
+    // Tracking-only copy where runs of LineTo points (and Polyline points)
+    // closer than tolerance to the previously kept point are dropped (the
+    // last point of each run is always kept). Other segments are copied
+    // unchanged.
+    fxGraphicsPath Decimated(double tolerance) const;
+
+    // Number of points stored in the segments
+    size_t GetPointCount() const
+    {
+        size_t count = 0;
+        for (const auto& seg : m_segments) count += seg.points.size();
+        return count;
+    }
+
+    // True if some circle/ellipse is smaller than size in both directions
+    bool HasMarkersBelow(double size) const;
+
+    // Tracking-only copy where circles/ellipses smaller than size are
+    // replaced by their bounding squares/rectangles
+    fxGraphicsPath WithSimplifiedMarkers(double size) const;
+
 private:
     wxGraphicsContext* m_gc = nullptr;
     wxGraphicsPath     m_path; 
     std::vector<fxPathSegment> m_segments;
 
+    // Helper: replay segment data into a native wxGraphicsPath
+    static void BuildNativePath(wxGraphicsPath& path, const std::vector<fxPathSegment>& segments);
+
     // Helper: compute bounding box from the segment data
     wxRect2DDouble ComputeSegmentsBoundingBox() const
     {
@@ -333,11 +403,15 @@ private:
         double maxx = -1e9, maxy = -1e9;
 
         for (auto& seg : m_segments) {
+            // Arcs and circles only store their center: grow by the radius
+            const bool centered = seg.type == fxPathSegmentType::Arc ||
+                                  (seg.type == fxPathSegmentType::Ellipse && seg.points.size() == 1);
+            const double r = centered ? std::abs(seg.radius) : 0.0;
             for (auto& pt : seg.points) {
-                if (pt.m_x < minx) minx = pt.m_x;
-                if (pt.m_x > maxx) maxx = pt.m_x;
-                if (pt.m_y < miny) miny = pt.m_y;
-                if (pt.m_y > maxy) maxy = pt.m_y;
+                if (pt.m_x - r < minx) minx = pt.m_x - r;
+                if (pt.m_x + r > maxx) maxx = pt.m_x + r;
+                if (pt.m_y - r < miny) miny = pt.m_y - r;
+                if (pt.m_y + r > maxy) maxy = pt.m_y + r;
             }
         }
         return wxRect2DDouble(minx, miny, maxx - minx, maxy - miny);
@@ -349,4 +423,13 @@ std::vector<wxPoint2DDouble> ApproxQuadBezier(wxPoint2DDouble p0, wxPoint2DDoubl
 std::vector<wxPoint2DDouble> ApproxCubicBezier(wxPoint2DDouble p0, wxPoint2DDouble c1, wxPoint2DDouble c2, wxPoint2DDouble p1, int steps = 12);
 std::vector<wxPoint2DDouble> ApproxArc(wxPoint2DDouble c, double r, double startAngle, double endAngle, bool clockwise, int steps = 12);
 
+// Number of steps keeping the flattened curve within tolerance (pixels) of the true curve.
+// A tolerance <= 0 returns defaultSteps.
+int ArcSteps(double radius, double sweepAngle, double tolerance, int defaultSteps = 12);
+int QuadBezierSteps(wxPoint2DDouble p0, wxPoint2DDouble c, wxPoint2DDouble p1, double tolerance, int defaultSteps = 12);
+int CubicBezierSteps(wxPoint2DDouble p0, wxPoint2DDouble c1, wxPoint2DDouble c2, wxPoint2DDouble p1, double tolerance, int defaultSteps = 12);
+
+// Number of vertices the DC fallback emits for a path flattened within tolerance
+size_t CountFlattenedVertices(const fxGraphicsPath& path, double tolerance = 0.0);
+
 #endif // FXGRAPHICSPATH_HPP
@@ -0,0 +1,179 @@
+// fxGridCache.cpp
+#include "fxGridCache.hpp"
+#include "fxMappedFile.hpp"
+#include <wx/file.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <cstring>
+
+namespace {
+
+const char     MAGIC[8]   = {'F', 'X', 'G', 'R', 'I', 'D', 0, 0};
+const uint32_t ENDIAN_MARK = 0x01020304;
+
+uint64_t AlignUp(uint64_t offset)
+{
+    return (offset + FX_GRID_CACHE_ALIGN - 1) / FX_GRID_CACHE_ALIGN * FX_GRID_CACHE_ALIGN;
+}
+
+// Size and modification time (ms) of the source file
+bool StatSource(const wxString& sourceFile, uint64_t& size, int64_t& mtime)
+{
+    wxFileName fn(sourceFile);
+    if (!fn.FileExists()) return false;
+
+    const wxULongLong fileSize = fn.GetSize();
+    if (fileSize == wxInvalidSize) return false;
+
+    size  = fileSize.GetValue();
+    mtime = fn.GetModificationTime().GetValue().GetValue();
+    return true;
+}
+
+bool WriteAt(wxFile& file, uint64_t& position, uint64_t offset, const void* data, size_t bytes)
+{
+    static const char zeros[FX_GRID_CACHE_ALIGN] = {};
+    if (offset > position && file.Write(zeros, offset - position) != offset - position) return false;
+    if (bytes > 0 && file.Write(data, bytes) != bytes) return false;
+    position = offset + bytes;
+    return true;
+}
+
+} // namespace
+
+wxString GetGridCacheFilename(const wxString& sourceFile)
+{
+    return sourceFile + ".fxgrid";
+}
+
+//--------------------------------------
+// Writing
+//--------------------------------------
+bool WriteGridCache(const wxString& cacheFile, const fxGridData& grid, const wxString& sourceFile)
+{
+    if (grid.IsEmpty()) return false;
+
+    fxGridCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version   = FX_GRID_CACHE_VERSION;
+    header.byteOrder = ENDIAN_MARK;
+    if (!StatSource(sourceFile, header.sourceSize, header.sourceMtime)) return false;
+
+    std::string names;
+    for (const auto& name : grid.GetColumnNames()) {
+        if (!names.empty()) names += '\n';
+        names += name.utf8_str();
+    }
+
+    const size_t rows = grid.GetRows(), cols = grid.GetCols();
+    header.rows       = rows;
+    header.cols       = cols;
+    header.corner     = grid.GetCorner();
+    header.flags      = grid.IsPolar() ? fxGridCacheHeader::FLAG_POLAR : 0;
+    header.namesBytes = static_cast<uint32_t>(names.size());
+
+    header.columnAxisOffset = AlignUp(sizeof(header));
+    header.rowAxisOffset    = AlignUp(header.columnAxisOffset + cols * sizeof(double));
+    header.valuesOffset     = AlignUp(header.rowAxisOffset + rows * sizeof(double));
+    header.namesOffset      = header.valuesOffset + rows * cols * sizeof(double);
+    header.fileSize         = header.namesOffset + names.size();
+
+    // Write aside and rename, so readers never map a partial file
+    const wxString tempFile = cacheFile + ".tmp";
+    {
+        wxFile file;
+        if (!file.Create(tempFile, true)) return false;
+
+        uint64_t position = 0;
+        const bool ok =
+            WriteAt(file, position, 0, &header, sizeof(header)) &&
+            WriteAt(file, position, header.columnAxisOffset, grid.GetColumnAxis(), cols * sizeof(double)) &&
+            WriteAt(file, position, header.rowAxisOffset, grid.GetRowAxis(), rows * sizeof(double)) &&
+            WriteAt(file, position, header.valuesOffset, grid.GetValues(), rows * cols * sizeof(double)) &&
+            WriteAt(file, position, header.namesOffset, names.data(), names.size());
+
+        if (!ok || !file.Close()) {
+            wxRemoveFile(tempFile);
+            return false;
+        }
+    }
+    return wxRenameFile(tempFile, cacheFile, true);
+}
+
+//--------------------------------------
+// Reading
+//--------------------------------------
+bool OpenGridCache(const wxString& cacheFile, const wxString& sourceFile, fxGridData& grid)
+{
+    auto mapping = std::make_shared<fxMappedFile>();
+    if (!mapping->Open(cacheFile) || mapping->Size() < sizeof(fxGridCacheHeader)) return false;
+
+    fxGridCacheHeader header;
+    std::memcpy(&header, mapping->Data(), sizeof(header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != FX_GRID_CACHE_VERSION ||
+        header.byteOrder != ENDIAN_MARK ||
+        header.fileSize != mapping->Size() ||
+        header.rows == 0 || header.cols == 0) {
+        return false;
+    }
+
+    // Stale cache?
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (!StatSource(sourceFile, sourceSize, sourceMtime) ||
+        sourceSize != header.sourceSize || sourceMtime != header.sourceMtime) {
+        return false;
+    }
+
+    // Every section inside the file, doubles aligned
+    const uint64_t rows = header.rows, cols = header.cols;
+    if (cols > header.fileSize / sizeof(double) || rows > header.fileSize / sizeof(double) ||
+        rows * cols > header.fileSize / sizeof(double)) {
+        return false;
+    }
+    auto inside = [&](uint64_t offset, uint64_t bytes) {
+        return offset % sizeof(double) == 0 && offset <= header.fileSize && bytes <= header.fileSize - offset;
+    };
+    if (!inside(header.columnAxisOffset, cols * sizeof(double)) ||
+        !inside(header.rowAxisOffset, rows * sizeof(double)) ||
+        !inside(header.valuesOffset, rows * cols * sizeof(double)) ||
+        header.namesOffset > header.fileSize || header.namesBytes > header.fileSize - header.namesOffset) {
+        return false;
+    }
+
+    const char* base = mapping->Data();
+
+    grid.Clear();
+    grid.m_rows   = static_cast<size_t>(rows);
+    grid.m_cols   = static_cast<size_t>(cols);
+    grid.m_corner = header.corner;
+    grid.m_polar  = (header.flags & fxGridCacheHeader::FLAG_POLAR) != 0;
+
+    const char* names = base + header.namesOffset;
+    const char* namesEnd = names + header.namesBytes;
+    while (names < namesEnd) {
+        const char* nl = static_cast<const char*>(std::memchr(names, '\n', namesEnd - names));
+        if (!nl) nl = namesEnd;
+        grid.m_columnNames.push_back(wxString::FromUTF8(names, nl - names));
+        names = nl + (nl < namesEnd ? 1 : 0);
+    }
+
+    grid.m_mappedColumnAxis = reinterpret_cast<const double*>(base + header.columnAxisOffset);
+    grid.m_mappedRowAxis    = reinterpret_cast<const double*>(base + header.rowAxisOffset);
+    grid.m_mappedValues     = reinterpret_cast<const double*>(base + header.valuesOffset);
+    grid.m_mapping          = std::move(mapping);
+    return true;
+}
+
+bool LoadGridDataCached(const wxString& filename, fxGridData& grid, wxString* error)
+{
+    const wxString cacheFile = GetGridCacheFilename(filename);
+    if (OpenGridCache(cacheFile, filename, grid)) return true;
+
+    if (!LoadGridData(filename, grid, error)) return false;
+    WriteGridCache(cacheFile, grid, filename);
+    return true;
+}
@@ -0,0 +1,62 @@
+// fxGridCache.hpp
+
+#ifndef FXGRIDCACHE_HPP
+#define FXGRIDCACHE_HPP
+
+#include <cstdint>
+#include <wx/string.h>
+#include "fxGridData.hpp"
+
+// Binary sidecar cache of a parsed grid file ("<source>.fxgrid").
+//
+// Layout (native byte order, checked on load):
+//   fxGridCacheHeader                       128 bytes
+//   column axis   cols doubles              offsets aligned to FX_GRID_CACHE_ALIGN
+//   row axis      rows doubles
+//   values        rows * cols doubles, row-major
+//   column names  '\n'-separated UTF-8
+// The cache is mapped, not read: opening it costs no parsing and no copy.
+// It is valid while the source file keeps the recorded size and mtime.
+
+const uint32_t FX_GRID_CACHE_VERSION = 1;
+const size_t   FX_GRID_CACHE_ALIGN   = 64;
+
+struct fxGridCacheHeader
+{
+    char     magic[8];          // "FXGRID\0\0"
+    uint32_t version;
+    uint32_t byteOrder;         // 0x01020304 as written
+    uint64_t fileSize;          // whole cache file
+    uint64_t sourceSize;
+    int64_t  sourceMtime;       // file clock ticks of the source
+    uint64_t rows;
+    uint64_t cols;
+    double   corner;
+    uint32_t flags;             // FLAG_POLAR
+    uint32_t namesBytes;
+    uint64_t columnAxisOffset;
+    uint64_t rowAxisOffset;
+    uint64_t valuesOffset;
+    uint64_t namesOffset;
+    uint8_t  reserved[24];
+
+    enum { FLAG_POLAR = 1 };
+};
+
+static_assert(sizeof(fxGridCacheHeader) == 128, "cache header layout changed");
+
+// Sidecar name for a source file
+wxString GetGridCacheFilename(const wxString& sourceFile);
+
+// Write grid to cacheFile, stamped with the size and mtime of sourceFile.
+// The file is written under a temporary name and renamed into place.
+bool WriteGridCache(const wxString& cacheFile, const fxGridData& grid, const wxString& sourceFile);
+
+// Map cacheFile into grid if it is well formed and up to date with sourceFile
+bool OpenGridCache(const wxString& cacheFile, const wxString& sourceFile, fxGridData& grid);
+
+// Map the sidecar cache when it is valid; otherwise parse the source and
+// refresh the cache (a failed cache write is not an error)
+bool LoadGridDataCached(const wxString& filename, fxGridData& grid, wxString* error = nullptr);
+
+#endif // FXGRIDCACHE_HPP
@@ -0,0 +1,242 @@
+// fxGridData.cpp
+#include "fxGridData.hpp"
+#include "fxMappedFile.hpp"
+#include "fxParallel.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// Below this many bytes per chunk, threads cost more than they save
+const size_t MIN_CHUNK_BYTES = 1 << 20;
+
+inline bool IsBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline const char* SkipBlanks(const char* p, const char* end)
+{
+    while (p < end && IsBlank(*p)) ++p;
+    return p;
+}
+
+inline const char* LineEnd(const char* p, const char* end)
+{
+    const void* nl = std::memchr(p, '\n', end - p);
+    return nl ? static_cast<const char*>(nl) : end;
+}
+
+// Start of the line after the one ending at lineEnd
+inline const char* NextLine(const char* lineEnd, const char* end)
+{
+    return lineEnd < end ? lineEnd + 1 : end;
+}
+
+// Parse one number of [p, end) and move p past it.
+// Accepts a leading '+' and 2- or 3-digit exponents (1.0E+000).
+bool ParseNumber(const char*& p, const char* end, double& value)
+{
+    p = SkipBlanks(p, end);
+    if (p == end) return false;
+    if (*p == '+') ++p;
+
+    auto result = std::from_chars(p, end, value);
+    if (result.ec == std::errc::invalid_argument) return false;
+    if (result.ec == std::errc::result_out_of_range) {
+        // Over/underflow: let strtod pick inf or 0
+        char buffer[64];
+        const size_t n = std::min<size_t>(result.ptr - p, sizeof(buffer) - 1);
+        std::memcpy(buffer, p, n);
+        buffer[n] = '\0';
+        value = std::strtod(buffer, nullptr);
+    }
+
+    // Numbers end at a blank or at the end of the line
+    if (result.ptr < end && !IsBlank(*result.ptr)) return false;
+    p = result.ptr;
+    return true;
+}
+
+// Parse every number of a line; false if some token isn't a number
+bool ParseNumbers(const char* p, const char* end, std::vector<double>& out)
+{
+    out.clear();
+    for (p = SkipBlanks(p, end); p < end; p = SkipBlanks(p, end)) {
+        double v;
+        if (!ParseNumber(p, end, v)) return false;
+        out.push_back(v);
+    }
+    return true;
+}
+
+// Blank lines and '!' comments carry no data
+inline bool IsDataLine(const char* p, const char* lineEnd)
+{
+    p = SkipBlanks(p, lineEnd);
+    return p < lineEnd && *p != '!';
+}
+
+std::vector<wxString> SplitWords(const char* p, const char* end)
+{
+    std::vector<wxString> words;
+    for (p = SkipBlanks(p, end); p < end; p = SkipBlanks(p, end)) {
+        const char* w = p;
+        while (p < end && !IsBlank(*p)) ++p;
+        words.push_back(wxString(w, p - w));
+    }
+    return words;
+}
+
+// A slice of the body, starting at a line start
+struct Chunk
+{
+    const char* begin;
+    const char* end;
+    size_t firstRow = 0;
+    size_t rows = 0;
+    wxString error;
+};
+
+size_t CountDataLines(const char* p, const char* end)
+{
+    size_t rows = 0;
+    while (p < end) {
+        const char* e = LineEnd(p, end);
+        if (IsDataLine(p, e)) ++rows;
+        p = NextLine(e, end);
+    }
+    return rows;
+}
+
+// Parse the rows of a chunk straight into the grid storage
+void ParseChunk(Chunk& chunk, size_t cols, double* rowAxis, double* values)
+{
+    size_t row = chunk.firstRow;
+    for (const char* p = chunk.begin; p < chunk.end; )
+    {
+        const char* e = LineEnd(p, chunk.end);
+        if (IsDataLine(p, e))
+        {
+            double* out = values + row * cols;
+            bool ok = ParseNumber(p, e, rowAxis[row]);
+            for (size_t c = 0; ok && c < cols; ++c) ok = ParseNumber(p, e, out[c]);
+            if (ok) ok = SkipBlanks(p, e) == e;
+
+            if (!ok) {
+                chunk.error = wxString::Format("data row %zu: expected a row value and %zu numbers", row + 1, cols);
+                return;
+            }
+            ++row;
+        }
+        p = NextLine(e, chunk.end);
+    }
+}
+
+} // namespace
+
+void fxGridData::Clear()
+{
+    *this = fxGridData();
+}
+
+//--------------------------------------
+// Parsing
+//--------------------------------------
+bool ParseGridData(const char* begin, const char* end, fxGridData& grid, wxString* error)
+{
+    grid.Clear();
+
+    auto fail = [&](const wxString& message) {
+        grid.Clear();
+        if (error) *error = message;
+        return false;
+    };
+
+    // Header: '!' lines, then (matrix layout) the axis row
+    const char* p = begin;
+    std::vector<double> numbers;
+    while (p < end)
+    {
+        const char* e = LineEnd(p, end);
+        const char* q = SkipBlanks(p, e);
+        if (q == e) { p = NextLine(e, end); continue; }
+        if (*q != '!') break;
+
+        grid.m_polar = true;
+        if (ParseNumbers(q + 1, e, numbers) && !numbers.empty()) {
+            grid.m_columnAxis = numbers;
+        } else {
+            grid.m_columnNames = SplitWords(q + 1, e);
+        }
+        p = NextLine(e, end);
+    }
+
+    if (grid.m_columnAxis.empty() && p < end)
+    {
+        const char* e = LineEnd(p, end);
+        if (!ParseNumbers(p, e, numbers) || numbers.size() < 2) {
+            return fail("first row: expected a corner value followed by the column axis");
+        }
+        grid.m_corner = numbers[0];
+        grid.m_columnAxis.assign(numbers.begin() + 1, numbers.end());
+        p = NextLine(e, end);
+    }
+    if (grid.m_columnAxis.empty()) return fail("no column axis found");
+
+    // Body: split at line starts, count rows per chunk, then parse in place
+    const char* body = p;
+    const size_t bytes = end - body;
+    const size_t chunks = bytes >= 2 * MIN_CHUNK_BYTES ? fxParallelThreads(bytes / MIN_CHUNK_BYTES) : 1;
+
+    std::vector<Chunk> parts(chunks);
+    const char* start = body;
+    for (size_t i = 0; i < chunks; ++i) {
+        const char* stop = (i + 1 == chunks) ? end : body + bytes * (i + 1) / chunks;
+        if (stop < start) stop = start;
+        if (stop < end) stop = NextLine(LineEnd(stop, end), end);
+        parts[i].begin = start;
+        parts[i].end   = stop;
+        start = stop;
+    }
+
+    fxParallelForEach(chunks, [&](size_t i) {
+        parts[i].rows = CountDataLines(parts[i].begin, parts[i].end);
+    });
+
+    size_t rows = 0;
+    for (auto& part : parts) {
+        part.firstRow = rows;
+        rows += part.rows;
+    }
+    if (rows == 0) return fail("no data rows found");
+
+    const size_t cols = grid.m_columnAxis.size();
+    grid.m_rowAxis.resize(rows);
+    grid.m_values.resize(rows * cols);
+
+    fxParallelForEach(chunks, [&](size_t i) {
+        ParseChunk(parts[i], cols, grid.m_rowAxis.data(), grid.m_values.data());
+    });
+
+    for (const auto& part : parts) {
+        if (!part.error.empty()) return fail(part.error);
+    }
+
+    grid.m_rows = rows;
+    grid.m_cols = cols;
+    return true;
+}
+
+bool LoadGridData(const wxString& filename, fxGridData& grid, wxString* error)
+{
+    fxMappedFile file;
+    if (!file.Open(filename)) {
+        grid.Clear();
+        if (error) *error = wxString::Format("cannot open %s", filename);
+        return false;
+    }
+    return ParseGridData(file.begin(), file.end(), grid, error);
+}
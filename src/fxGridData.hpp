@@ -0,0 +1,77 @@
+// fxGridData.hpp
+
+#ifndef FXGRIDDATA_HPP
+#define FXGRIDDATA_HPP
+
+#include <memory>
+#include <vector>
+#include <wx/string.h>
+
+class fxMappedFile;
+
+// A rectilinear grid of samples as written by our solvers.
+//
+// Two text layouts are recognized:
+//  - polar (polar_grid.dat): '!' header lines; the last header line holding
+//    only numbers is the column axis (angles), each data row is the row axis
+//    value (radius) followed by one value per column;
+//  - matrix (exact_grid, loop_*): the first row is a corner value followed by
+//    the column axis, each following row is the row axis value followed by
+//    one value per column.
+// Values are stored row-major: values[row * cols + col]. The arrays are either
+// owned or point into a memory-mapped cache file (see fxGridCache.hpp), which
+// stays mapped as long as some copy of the grid refers to it.
+class fxGridData
+{
+public:
+    fxGridData() = default;
+
+    size_t GetRows() const { return m_rows; }
+    size_t GetCols() const { return m_cols; }
+    bool IsEmpty() const { return m_rows == 0 || m_cols == 0; }
+
+    const double* GetColumnAxis() const { return m_mapping ? m_mappedColumnAxis : m_columnAxis.data(); }  // x / angle
+    const double* GetRowAxis() const { return m_mapping ? m_mappedRowAxis : m_rowAxis.data(); }           // y / radius
+    const double* GetValues() const { return m_mapping ? m_mappedValues : m_values.data(); }
+
+    double At(size_t row, size_t col) const { return GetValues()[row * m_cols + col]; }
+    const double* Row(size_t row) const { return GetValues() + row * m_cols; }
+
+    const std::vector<wxString>& GetColumnNames() const { return m_columnNames; }  // from a '!' name header
+    double GetCorner() const { return m_corner; }   // top-left entry of the matrix layout
+    bool IsPolar() const { return m_polar; }        // read from the '!' header layout
+    bool IsMapped() const { return m_mapping != nullptr; }
+
+    void Clear();
+
+private:
+    friend bool ParseGridData(const char*, const char*, fxGridData&, wxString*);
+    friend bool OpenGridCache(const wxString&, const wxString&, fxGridData&);
+
+    size_t m_rows = 0;
+    size_t m_cols = 0;
+    double m_corner = 0.0;
+    bool   m_polar = false;
+    std::vector<wxString> m_columnNames;
+
+    // Owned storage
+    std::vector<double> m_columnAxis;
+    std::vector<double> m_rowAxis;
+    std::vector<double> m_values;
+
+    // Mapped storage
+    std::shared_ptr<const fxMappedFile> m_mapping;
+    const double* m_mappedColumnAxis = nullptr;
+    const double* m_mappedRowAxis = nullptr;
+    const double* m_mappedValues = nullptr;
+};
+
+// Load a grid file through a memory mapping. Large files are parsed in
+// parallel chunks split at line boundaries. On failure the grid is left
+// empty and a message is stored in error (if given).
+bool LoadGridData(const wxString& filename, fxGridData& grid, wxString* error = nullptr);
+
+// Parse grid text held in memory
+bool ParseGridData(const char* begin, const char* end, fxGridData& grid, wxString* error = nullptr);
+
+#endif // FXGRIDDATA_HPP
@@ -0,0 +1,468 @@
+// fxHeatmap.cpp
+#include "fxHeatmap.hpp"
+#include "fxParallel.hpp"
+#include "fxSimd.hpp"
+#include "fxTrace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace {
+
+const double TWO_PI = 6.283185307179586;
+
+// Image rows per parallel task
+const size_t ROWS_PER_TASK = 16;
+
+// Interval [axis[i], axis[i+1]] holding v (clamped to the axis) and the weight
+// of axis[i+1]. The axis is monotonic, ascending or descending.
+size_t Locate(const double* axis, size_t n, double v, double& weight)
+{
+    const bool ascending = axis[n - 1] >= axis[0];
+    size_t i = ascending ? std::upper_bound(axis, axis + n, v) - axis
+                         : std::upper_bound(axis, axis + n, v, std::greater<double>()) - axis;
+    i = std::min(i == 0 ? 0 : i - 1, n - 2);
+
+    const double step = axis[i + 1] - axis[i];
+    weight = step != 0.0 ? std::clamp((v - axis[i]) / step, 0.0, 1.0) : 0.0;
+    return i;
+}
+
+bool InsideAxis(const double* axis, size_t n, double v)
+{
+    return v >= std::min(axis[0], axis[n - 1]) && v <= std::max(axis[0], axis[n - 1]);
+}
+
+#if FX_SIMD_AVX2
+// AVX2 part of GatherPolar: whole groups of 4 pixels, returns the count done
+FX_TARGET_AVX2
+size_t GatherPolarAVX2(const double* values, int32_t rowStep, const int32_t* offset, const int32_t* angleStep,
+                       const float* radiusWeight, const float* angleWeight, size_t n, double* out)
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    size_t i = 0;
+    const __m128i rows  = _mm_set1_epi32(rowStep);
+    const __m128i minus = _mm_set1_epi32(-1);
+    const __m256d nans  = _mm256_set1_pd(nan);
+    for (; i + 4 <= n; i += 4) {
+        const __m128i valid = _mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(offset + i)), minus);
+        // Pixels without data read sample 0 and are masked afterwards
+        const __m128i o0 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(offset + i)), valid);
+        const __m128i o1 = _mm_add_epi32(o0,
+            _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(angleStep + i)), valid));
+
+        const __m256d v00 = _mm256_i32gather_pd(values, o0, 8);
+        const __m256d v01 = _mm256_i32gather_pd(values, o1, 8);
+        const __m256d v10 = _mm256_i32gather_pd(values, _mm_add_epi32(o0, rows), 8);
+        const __m256d v11 = _mm256_i32gather_pd(values, _mm_add_epi32(o1, rows), 8);
+
+        const __m256d wa = _mm256_cvtps_pd(_mm_loadu_ps(angleWeight + i));
+        const __m256d wr = _mm256_cvtps_pd(_mm_loadu_ps(radiusWeight + i));
+        const __m256d lo = _mm256_add_pd(v00, _mm256_mul_pd(wa, _mm256_sub_pd(v01, v00)));
+        const __m256d hi = _mm256_add_pd(v10, _mm256_mul_pd(wa, _mm256_sub_pd(v11, v10)));
+        const __m256d v  = _mm256_add_pd(lo, _mm256_mul_pd(wr, _mm256_sub_pd(hi, lo)));
+
+        const __m256d mask = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(valid));
+        _mm256_storeu_pd(out + i, _mm256_blendv_pd(nans, v, mask));
+    }
+    return i;
+}
+#endif
+
+// Bilinear gather of n pixels: NaN where offset < 0
+void GatherPolar(const double* values, int32_t rowStep, const int32_t* offset, const int32_t* angleStep,
+                 const float* radiusWeight, const float* angleWeight, size_t n, double* out)
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    size_t i = 0;
+
+#if FX_SIMD_AVX2
+    if (fxHasAVX2()) i = GatherPolarAVX2(values, rowStep, offset, angleStep, radiusWeight, angleWeight, n, out);
+#endif
+
+    for (; i < n; ++i) {
+        if (offset[i] < 0) { out[i] = nan; continue; }
+        const double* p = values + offset[i];
+        const int32_t s = angleStep[i];
+        const double wa = angleWeight[i], wr = radiusWeight[i];
+        const double lo = p[0] + wa * (p[s] - p[0]);
+        const double hi = p[rowStep] + wa * (p[rowStep + s] - p[rowStep]);
+        out[i] = lo + wr * (hi - lo);
+    }
+}
+
+// Filter taps at v: grid indices and weights (taps = 2 or 4)
+void FilterTaps(const double* axis, size_t n, double v, size_t taps, int32_t* index, float* weight)
+{
+    double t;
+    const size_t i = Locate(axis, n, v, t);
+    if (taps == 2) {
+        index[0]  = static_cast<int32_t>(i);
+        index[1]  = static_cast<int32_t>(i + 1);
+        weight[0] = static_cast<float>(1.0 - t);
+        weight[1] = static_cast<float>(t);
+        return;
+    }
+
+    // Catmull-Rom, samples repeated at the ends
+    const double t2 = t * t, t3 = t2 * t;
+    const double w[4] = {0.5 * (-t3 + 2.0 * t2 - t),
+                         0.5 * (3.0 * t3 - 5.0 * t2 + 2.0),
+                         0.5 * (-3.0 * t3 + 4.0 * t2 + t),
+                         0.5 * (t3 - t2)};
+    for (size_t k = 0; k < 4; ++k) {
+        const long j = static_cast<long>(i + k) - 1;
+        index[k]  = static_cast<int32_t>(std::clamp<long>(j, 0, static_cast<long>(n) - 1));
+        weight[k] = static_cast<float>(w[k]);
+    }
+}
+
+#if FX_SIMD_AVX2
+FX_TARGET_AVX2
+size_t BlendRowsAVX2(const double* const* rows, const float* weight, size_t taps,
+                     const int32_t* cols, size_t n, double* line)
+{
+    size_t u = 0;
+    for (; u + 4 <= n; u += 4) {
+        const __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cols + u));
+        __m256d sum = _mm256_mul_pd(_mm256_set1_pd(weight[0]), _mm256_i32gather_pd(rows[0], index, 8));
+        for (size_t k = 1; k < taps; ++k) {
+            sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_set1_pd(weight[k]), _mm256_i32gather_pd(rows[k], index, 8)));
+        }
+        _mm256_storeu_pd(line + u, sum);
+    }
+    return u;
+}
+#endif
+
+// line[u] = sum over k of weight[k] * rows[k][cols[u]]
+void BlendRows(const double* const* rows, const float* weight, size_t taps,
+               const int32_t* cols, size_t n, double* line)
+{
+    size_t u = 0;
+
+#if FX_SIMD_AVX2
+    if (fxHasAVX2()) u = BlendRowsAVX2(rows, weight, taps, cols, n, line);
+#endif
+
+    for (; u < n; ++u) {
+        double sum = double(weight[0]) * rows[0][cols[u]];
+        for (size_t k = 1; k < taps; ++k) sum += double(weight[k]) * rows[k][cols[u]];
+        line[u] = sum;
+    }
+}
+
+#if FX_SIMD_AVX2
+FX_TARGET_AVX2
+size_t BlendColumnsAVX2(const double* line, const int32_t* pos, const float* weight, size_t taps,
+                        size_t width, double* out)
+{
+    size_t px = 0;
+    for (; px + 4 <= width; px += 4) {
+        __m256d sum = _mm256_setzero_pd();
+        for (size_t k = 0; k < taps; ++k) {
+            const size_t at = k * width + px;
+            const __m256d w = _mm256_cvtps_pd(_mm_loadu_ps(weight + at));
+            const __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos + at));
+            const __m256d v = _mm256_mul_pd(w, _mm256_i32gather_pd(line, index, 8));
+            sum = k == 0 ? v : _mm256_add_pd(sum, v);
+        }
+        _mm256_storeu_pd(out + px, sum);
+    }
+    return px;
+}
+#endif
+
+// out[px] = sum over k of weight[k * width + px] * line[pos[k * width + px]]
+void BlendColumns(const double* line, const int32_t* pos, const float* weight, size_t taps,
+                  size_t width, double* out)
+{
+    size_t px = 0;
+
+#if FX_SIMD_AVX2
+    if (fxHasAVX2()) px = BlendColumnsAVX2(line, pos, weight, taps, width, out);
+#endif
+
+    for (; px < width; ++px) {
+        double sum = double(weight[px]) * line[pos[px]];
+        for (size_t k = 1; k < taps; ++k) {
+            const size_t at = k * width + px;
+            sum += double(weight[at]) * line[pos[at]];
+        }
+        out[px] = sum;
+    }
+}
+
+} // namespace
+
+//--------------------------------------
+// fxPolarHeatmap
+//--------------------------------------
+void fxPolarHeatmap::SetDataRect(const wxRect2DDouble& rect)
+{
+    if (rect.m_x != m_dataRect.m_x || rect.m_y != m_dataRect.m_y ||
+        rect.m_width != m_dataRect.m_width || rect.m_height != m_dataRect.m_height) {
+        m_dataRect = rect;
+        Invalidate();
+    }
+}
+
+size_t fxPolarHeatmap::GetLookupBytes() const
+{
+    return m_offset.size() * sizeof(int32_t) + m_angleStep.size() * sizeof(int32_t) +
+           m_radiusWeight.size() * sizeof(float) + m_angleWeight.size() * sizeof(float);
+}
+
+//--------------------------------------
+// Lookup table
+//--------------------------------------
+bool fxPolarHeatmap::IsLookupValid(const fxGridData& grid, const wxSize& size) const
+{
+    return size == m_size &&
+           grid.GetRows() == m_radii.size() && grid.GetCols() == m_angles.size() &&
+           std::equal(m_radii.begin(), m_radii.end(), grid.GetRowAxis()) &&
+           std::equal(m_angles.begin(), m_angles.end(), grid.GetColumnAxis());
+}
+
+void fxPolarHeatmap::BuildLookup(const fxGridData& grid, const wxSize& size)
+{
+    FX_TRACE_SCOPE(Encode, "PolarLookup");
+
+    const size_t rows = grid.GetRows(), cols = grid.GetCols();
+    m_radii.assign(grid.GetRowAxis(), grid.GetRowAxis() + rows);
+    m_angles.assign(grid.GetColumnAxis(), grid.GetColumnAxis() + cols);
+    m_size = size;
+
+    const size_t width = size.GetWidth(), height = size.GetHeight();
+    m_offset.assign(width * height, -1);
+    m_angleStep.assign(width * height, 0);
+    m_radiusWeight.assign(width * height, 0.0f);
+    m_angleWeight.assign(width * height, 0.0f);
+
+    // The gap between the last and the first angle closes the circle when it
+    // is no wider than a couple of axis steps
+    const double first = m_angles.front(), last = m_angles.back();
+    double maxStep = 0.0;
+    for (size_t j = 1; j < cols; ++j) maxStep = std::max(maxStep, m_angles[j] - m_angles[j - 1]);
+    const double gap = first + TWO_PI - last;
+    const bool periodic = gap > 0.0 && gap <= 2.0 * maxStep;
+
+    const double dx = m_dataRect.m_width / width;
+    const double dy = m_dataRect.m_height / height;
+    const double top = m_dataRect.m_y + m_dataRect.m_height;
+
+    fxParallelFor(height, ROWS_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t py = begin; py < end; ++py) {
+            const double y = top - (py + 0.5) * dy;
+            for (size_t px = 0; px < width; ++px) {
+                const double x = m_dataRect.m_x + (px + 0.5) * dx;
+                const double r = std::hypot(x, y);
+                if (!InsideAxis(m_radii.data(), rows, r)) continue;
+
+                // Angle brought into [first, first + 2 pi)
+                double a = std::fmod(std::atan2(y, x) - first, TWO_PI);
+                if (a < 0.0) a += TWO_PI;
+                a += first;
+
+                const size_t k = py * width + px;
+                size_t j;
+                double weight;
+                if (a <= last) {
+                    j = Locate(m_angles.data(), cols, a, weight);
+                    m_angleWeight[k] = static_cast<float>(weight);
+                    m_angleStep[k] = 1;
+                } else if (periodic) {
+                    j = cols - 1;
+                    m_angleWeight[k] = static_cast<float>((a - last) / gap);
+                    m_angleStep[k] = -static_cast<int32_t>(cols - 1);
+                } else {
+                    continue;
+                }
+
+                const size_t i = Locate(m_radii.data(), rows, r, weight);
+                m_radiusWeight[k] = static_cast<float>(weight);
+                m_offset[k] = static_cast<int32_t>(i * cols + j);
+            }
+        }
+    });
+}
+
+//--------------------------------------
+// Rendering
+//--------------------------------------
+wxImage fxPolarHeatmap::Render(const fxGridData& grid, const fxColormap& colormap, const wxSize& size)
+{
+    const size_t rows = grid.GetRows(), cols = grid.GetCols();
+    if (rows < 2 || cols < 2 || size.GetWidth() <= 0 || size.GetHeight() <= 0) return wxImage();
+    // Offsets are 32-bit (the width of the AVX2 gather indices)
+    if (rows * cols > size_t(std::numeric_limits<int32_t>::max())) return wxImage();
+
+    if (!IsLookupValid(grid, size)) BuildLookup(grid, size);
+
+    FX_TRACE_SCOPE(Encode, "PolarHeatmap");
+
+    const size_t width = size.GetWidth();
+    wxImage image(size.GetWidth(), size.GetHeight(), false);
+    image.InitAlpha();
+    unsigned char* rgb = image.GetData();
+    unsigned char* alpha = image.GetAlpha();
+    const double* values = grid.GetValues();
+
+    fxParallelFor(size.GetHeight(), ROWS_PER_TASK, [&](size_t begin, size_t end) {
+        std::vector<double> line(width);
+        for (size_t py = begin; py < end; ++py) {
+            const size_t k = py * width;
+            GatherPolar(values, static_cast<int32_t>(cols), &m_offset[k], &m_angleStep[k],
+                        &m_radiusWeight[k], &m_angleWeight[k], width, line.data());
+            colormap.Map(line.data(), width, rgb + 3 * k, alpha + k);
+
+            // Outside the grid: transparent whatever the NaN colour
+            for (size_t px = 0; px < width; ++px) {
+                if (m_offset[k + px] < 0) alpha[k + px] = 0;
+            }
+        }
+    });
+    return image;
+}
+
+void fxPolarHeatmap::Draw(fxDrawingContext& ctx, const fxGridData& grid, const fxColormap& colormap,
+                          wxDouble x, wxDouble y, wxDouble w, wxDouble h)
+{
+    ctx.DrawImage(Render(grid, colormap, ctx.GetDeviceSize(w, h)), x, y, w, h);
+}
+
+//--------------------------------------
+// fxGridHeatmap
+//--------------------------------------
+void fxGridHeatmap::SetDataRect(const wxRect2DDouble& rect)
+{
+    if (rect.m_x != m_dataRect.m_x || rect.m_y != m_dataRect.m_y ||
+        rect.m_width != m_dataRect.m_width || rect.m_height != m_dataRect.m_height) {
+        m_dataRect = rect;
+        Invalidate();
+    }
+}
+
+void fxGridHeatmap::SetFilter(fxResampleFilter filter)
+{
+    if (filter != m_filter) {
+        m_filter = filter;
+        Invalidate();
+    }
+}
+
+bool fxGridHeatmap::IsLookupValid(const fxGridData& grid, const wxSize& size) const
+{
+    return size == m_size &&
+           grid.GetCols() == m_xAxis.size() && grid.GetRows() == m_yAxis.size() &&
+           std::equal(m_xAxis.begin(), m_xAxis.end(), grid.GetColumnAxis()) &&
+           std::equal(m_yAxis.begin(), m_yAxis.end(), grid.GetRowAxis());
+}
+
+void fxGridHeatmap::BuildLookup(const fxGridData& grid, const wxSize& size)
+{
+    FX_TRACE_SCOPE(Encode, "GridLookup");
+
+    const size_t rows = grid.GetRows(), cols = grid.GetCols();
+    m_xAxis.assign(grid.GetColumnAxis(), grid.GetColumnAxis() + cols);
+    m_yAxis.assign(grid.GetRowAxis(), grid.GetRowAxis() + rows);
+    m_size = size;
+    m_taps = m_filter == fxResampleFilter::Bicubic ? 4 : 2;
+
+    const size_t width = size.GetWidth(), height = size.GetHeight();
+
+    // Rows
+    const double dy = m_dataRect.m_height / height;
+    const double top = m_dataRect.m_y + m_dataRect.m_height;
+    m_rowIndex.assign(height * m_taps, 0);
+    m_rowWeight.assign(height * m_taps, 0.0f);
+    m_rowInside.assign(height, 0);
+    for (size_t py = 0; py < height; ++py) {
+        const double y = top - (py + 0.5) * dy;
+        if (!InsideAxis(m_yAxis.data(), rows, y)) continue;
+        FilterTaps(m_yAxis.data(), rows, y, m_taps, &m_rowIndex[py * m_taps], &m_rowWeight[py * m_taps]);
+        m_rowInside[py] = 1;
+    }
+
+    // Columns, tap-major so that consecutive pixels are contiguous
+    const double dx = m_dataRect.m_width / width;
+    std::vector<int32_t> index(m_taps);
+    std::vector<float> weight(m_taps);
+    m_colPos.assign(width * m_taps, 0);
+    m_colWeight.assign(width * m_taps, 0.0f);
+    m_colInside.assign(width, 0);
+    for (size_t px = 0; px < width; ++px) {
+        const double x = m_dataRect.m_x + (px + 0.5) * dx;
+        if (!InsideAxis(m_xAxis.data(), cols, x)) continue;
+        FilterTaps(m_xAxis.data(), cols, x, m_taps, index.data(), weight.data());
+        for (size_t k = 0; k < m_taps; ++k) {
+            m_colPos[k * width + px] = index[k];
+            m_colWeight[k * width + px] = weight[k];
+        }
+        m_colInside[px] = 1;
+    }
+
+    // Keep only the grid columns some pixel reads, and point the taps at them
+    std::vector<int32_t> position(cols, -1);
+    for (size_t px = 0; px < width; ++px) {
+        if (!m_colInside[px]) continue;
+        for (size_t k = 0; k < m_taps; ++k) position[m_colPos[k * width + px]] = 0;
+    }
+    m_usedCols.clear();
+    for (size_t c = 0; c < cols; ++c) {
+        if (position[c] < 0) continue;
+        position[c] = static_cast<int32_t>(m_usedCols.size());
+        m_usedCols.push_back(static_cast<int32_t>(c));
+    }
+    if (m_usedCols.empty()) m_usedCols.push_back(0);    // taps of outside pixels read entry 0
+
+    for (size_t px = 0; px < width; ++px) {
+        if (!m_colInside[px]) continue;
+        for (size_t k = 0; k < m_taps; ++k) m_colPos[k * width + px] = position[m_colPos[k * width + px]];
+    }
+}
+
+wxImage fxGridHeatmap::Render(const fxGridData& grid, const fxColormap& colormap, const wxSize& size)
+{
+    if (grid.GetRows() < 2 || grid.GetCols() < 2 || size.GetWidth() <= 0 || size.GetHeight() <= 0) return wxImage();
+
+    if (!IsLookupValid(grid, size)) BuildLookup(grid, size);
+
+    FX_TRACE_SCOPE(Encode, "GridHeatmap");
+
+    const size_t width = size.GetWidth();
+    wxImage image(size.GetWidth(), size.GetHeight(), false);
+    image.InitAlpha();
+    unsigned char* rgb = image.GetData();
+    unsigned char* alpha = image.GetAlpha();
+
+    fxParallelFor(size.GetHeight(), ROWS_PER_TASK, [&](size_t begin, size_t end) {
+        std::vector<double> line(m_usedCols.size()), pixels(width);
+        std::vector<const double*> taps(m_taps);
+        for (size_t py = begin; py < end; ++py) {
+            const size_t k = py * width;
+            if (!m_rowInside[py]) {
+                std::fill(rgb + 3 * k, rgb + 3 * (k + width), 0);
+                std::fill(alpha + k, alpha + k + width, 0);
+                continue;
+            }
+
+            for (size_t t = 0; t < m_taps; ++t) taps[t] = grid.Row(m_rowIndex[py * m_taps + t]);
+            BlendRows(taps.data(), &m_rowWeight[py * m_taps], m_taps, m_usedCols.data(), m_usedCols.size(), line.data());
+            BlendColumns(line.data(), m_colPos.data(), m_colWeight.data(), m_taps, width, pixels.data());
+            colormap.Map(pixels.data(), width, rgb + 3 * k, alpha + k);
+
+            for (size_t px = 0; px < width; ++px) {
+                if (!m_colInside[px]) alpha[k + px] = 0;
+            }
+        }
+    });
+    return image;
+}
+
+void fxGridHeatmap::Draw(fxDrawingContext& ctx, const fxGridData& grid, const fxColormap& colormap,
+                         wxDouble x, wxDouble y, wxDouble w, wxDouble h)
+{
+    ctx.DrawImage(Render(grid, colormap, ctx.GetDeviceSize(w, h)), x, y, w, h);
+}
@@ -0,0 +1,140 @@
+// fxHeatmap.hpp
+
+#ifndef FXHEATMAP_HPP
+#define FXHEATMAP_HPP
+
+#include <cstdint>
+#include <vector>
+#include <wx/geometry.h>
+#include <wx/image.h>
+#include "fxColormap.hpp"
+#include "fxDrawingContext.hpp"
+#include "fxGridData.hpp"
+
+// Heatmap of a polar grid (row axis = radius, column axis = angle in radians,
+// both ascending), drawn as one bitmap.
+//
+// For every pixel of the image the grid cell under it and the bilinear
+// weights are computed once and kept in a lookup table; the table is rebuilt
+// only when the data rectangle, the image size or the grid axes change.
+// Rendering another time step of the same grid is then a gather of four
+// values per pixel followed by the colormap pass, both split by image rows
+// over all cores.
+//
+// The data rectangle is in cartesian data coordinates, x = r cos(angle) and
+// y = r sin(angle), with y pointing up (the top image row is the rectangle's
+// bottom edge, i.e. its largest y). The angle axis wraps around when it covers
+// the whole circle; pixels outside the radius range or outside a partial
+// angle range stay transparent.
+class fxPolarHeatmap
+{
+public:
+    fxPolarHeatmap() = default;
+
+    void SetDataRect(const wxRect2DDouble& rect);
+    const wxRect2DDouble& GetDataRect() const { return m_dataRect; }
+
+    // Image of the grid at the given pixel size
+    wxImage Render(const fxGridData& grid, const fxColormap& colormap, const wxSize& size);
+
+    // Render at the device size of the rectangle and draw it there
+    void Draw(fxDrawingContext& ctx, const fxGridData& grid, const fxColormap& colormap,
+              wxDouble x, wxDouble y, wxDouble w, wxDouble h);
+
+    // Force the lookup table to be rebuilt
+    void Invalidate() { m_size = wxSize(); }
+
+    // Memory held by the lookup table
+    size_t GetLookupBytes() const;
+
+private:
+    wxRect2DDouble m_dataRect = wxRect2DDouble(-1.0, -1.0, 2.0, 2.0);
+
+    // Lookup key
+    wxSize m_size;
+    std::vector<double> m_radii;
+    std::vector<double> m_angles;
+
+    // Per pixel, row-major: offset of the lower-left sample (-1 = no data),
+    // offset step to the next angle (wraps at the end of the axis), and the
+    // weights of the next radius and the next angle
+    std::vector<int32_t> m_offset;
+    std::vector<int32_t> m_angleStep;
+    std::vector<float>   m_radiusWeight;
+    std::vector<float>   m_angleWeight;
+
+    bool IsLookupValid(const fxGridData& grid, const wxSize& size) const;
+    void BuildLookup(const fxGridData& grid, const wxSize& size);
+};
+
+enum class fxResampleFilter
+{
+    Bilinear = 0,
+    Bicubic     // Catmull-Rom in index space, passes through the samples
+};
+
+// Heatmap of a cartesian grid (column axis = x, row axis = y), resampled to
+// the device resolution and drawn as one bitmap instead of one rectangle per
+// cell.
+//
+// The axes may be non-uniform and ascending or descending. The filter is
+// separable: for every image column and every image row the grid indices and
+// weights of the taps are computed once and kept until the data rectangle,
+// the image size, the filter or the grid axes change. A render then runs two
+// passes per image row, split by rows over all cores: the grid rows under the
+// image row are blended over the grid columns actually read, and the result
+// is blended across into the pixels.
+//
+// The data rectangle follows the same convention as fxPolarHeatmap (y up).
+// Pixels outside the axis ranges stay transparent.
+class fxGridHeatmap
+{
+public:
+    fxGridHeatmap() = default;
+
+    void SetDataRect(const wxRect2DDouble& rect);
+    const wxRect2DDouble& GetDataRect() const { return m_dataRect; }
+
+    void SetFilter(fxResampleFilter filter);
+    fxResampleFilter GetFilter() const { return m_filter; }
+
+    // Image of the grid at the given pixel size
+    wxImage Render(const fxGridData& grid, const fxColormap& colormap, const wxSize& size);
+
+    // Render at the device size of the rectangle and draw it there
+    void Draw(fxDrawingContext& ctx, const fxGridData& grid, const fxColormap& colormap,
+              wxDouble x, wxDouble y, wxDouble w, wxDouble h);
+
+    // Force the lookup tables to be rebuilt
+    void Invalidate() { m_size = wxSize(); }
+
+private:
+    wxRect2DDouble   m_dataRect = wxRect2DDouble(0.0, 0.0, 1.0, 1.0);
+    fxResampleFilter m_filter = fxResampleFilter::Bilinear;
+
+    // Lookup key
+    wxSize m_size;
+    std::vector<double> m_xAxis;
+    std::vector<double> m_yAxis;
+
+    // Taps per pixel and direction (2 or 4)
+    size_t m_taps = 2;
+
+    // Per image row: grid rows and weights, [py * m_taps + k]
+    std::vector<int32_t> m_rowIndex;
+    std::vector<float>   m_rowWeight;
+    std::vector<uint8_t> m_rowInside;
+
+    // Grid columns read by some pixel, in order
+    std::vector<int32_t> m_usedCols;
+
+    // Per image column: position in m_usedCols and weights, [k * width + px]
+    std::vector<int32_t> m_colPos;
+    std::vector<float>   m_colWeight;
+    std::vector<uint8_t> m_colInside;
+
+    bool IsLookupValid(const fxGridData& grid, const wxSize& size) const;
+    void BuildLookup(const fxGridData& grid, const wxSize& size);
+};
+
+#endif // FXHEATMAP_HPP
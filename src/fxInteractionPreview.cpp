@@ -0,0 +1,120 @@
+// fxInteractionPreview.cpp
+#include "fxInteractionPreview.hpp"
+#include <wx/dcmemory.h>
+
+fxInteractionPreview::fxInteractionPreview(wxWindow* window, int idleDelayMs)
+    : m_window(window), m_idleDelayMs(idleDelayMs)
+{
+    m_idleTimer.SetOwner(this);
+    Bind(wxEVT_TIMER, &fxInteractionPreview::OnIdleTimer, this);
+}
+
+fxInteractionPreview::~fxInteractionPreview()
+{
+    m_idleTimer.Stop();
+}
+
+//--------------------------------------
+// Interaction
+//--------------------------------------
+void fxInteractionPreview::Pan(wxDouble dx, wxDouble dy)
+{
+    m_offset.m_x += dx;
+    m_offset.m_y += dy;
+    Touch();
+}
+
+void fxInteractionPreview::Zoom(wxDouble factor, const wxPoint2DDouble& center)
+{
+    if (factor <= 0.0) return;
+
+    // Scale the current preview mapping around the zoom center
+    m_scale *= factor;
+    m_offset.m_x = factor * (m_offset.m_x - center.m_x) + center.m_x;
+    m_offset.m_y = factor * (m_offset.m_y - center.m_y) + center.m_y;
+    Touch();
+}
+
+// Any interaction restarts the idle countdown
+void fxInteractionPreview::Touch()
+{
+    m_interacting = true;
+    m_idleTimer.StartOnce(m_idleDelayMs);
+    RequestRefresh();
+}
+
+void fxInteractionPreview::RequestRefresh()
+{
+    if (m_refresh) {
+        m_refresh();
+    } else if (m_window) {
+        m_window->Refresh(false);
+    }
+}
+
+void fxInteractionPreview::OnIdleTimer(wxTimerEvent&)
+{
+    // Interaction is over: schedule the full-quality frame
+    m_interacting = false;
+    m_frameValid  = false;
+    RequestRefresh();
+}
+
+//--------------------------------------
+// Render
+//--------------------------------------
+void fxInteractionPreview::Render(fxDrawingContext& ctx)
+{
+    if (!ctx.IsValid() || !m_renderer) return;
+
+    // Nothing to reuse on vector targets
+    if (!ctx.IsRasterTarget()) {
+        m_renderer(ctx);
+        return;
+    }
+
+    const wxSize size = ctx.GetSize();
+
+    if (m_interacting && m_frame.IsOk())
+    {
+        // Preview: clear, then blit the last frame transformed
+        ctx.SetPen(*wxTRANSPARENT_PEN);
+        ctx.SetBrush(wxBrush(m_background));
+        ctx.DrawRectangle(0, 0, size.GetWidth(), size.GetHeight());
+        ctx.DrawBitmap(m_frame, m_offset.m_x, m_offset.m_y,
+                       m_scale * m_frame.GetWidth(), m_scale * m_frame.GetHeight());
+        return;
+    }
+
+    if (!m_frameValid || !m_frame.IsOk() || m_frame.GetSize() != size) {
+        RenderFrame(size);
+    }
+
+    if (m_frame.IsOk()) {
+        ctx.DrawBitmap(m_frame, 0, 0, m_frame.GetWidth(), m_frame.GetHeight());
+    }
+}
+
+void fxInteractionPreview::RenderFrame(const wxSize& size)
+{
+    m_scale  = 1.0;
+    m_offset = wxPoint2DDouble(0, 0);
+
+    if (size.GetWidth() <= 0 || size.GetHeight() <= 0) {
+        m_frame = wxBitmap();
+        return;
+    }
+
+    m_frame = wxBitmap(size.GetWidth(), size.GetHeight());
+    wxMemoryDC memDC(m_frame);
+    memDC.SetBackground(wxBrush(m_background));
+    memDC.Clear();
+    {
+        // The GC must be gone before the bitmap is deselected
+        fxDrawingContext frameCtx(&memDC);
+        m_renderer(frameCtx);
+    }
+    memDC.SelectObject(wxNullBitmap);
+
+    m_frameValid = true;
+}
@@ -0,0 +1,80 @@
+// fxInteractionPreview.hpp
+
+#ifndef FXINTERACTIONPREVIEW_HPP
+#define FXINTERACTIONPREVIEW_HPP
+
+#include <functional>
+#include <wx/bitmap.h>
+#include <wx/timer.h>
+#include <wx/window.h>
+#include "fxDrawingContext.hpp"
+
+// Full-quality renderer of the view
+using fxViewRenderer = std::function<void(fxDrawingContext&)>;
+
+// Pan/zoom preview from the last rendered frame.
+// The view is rendered off-screen and kept as a bitmap. While the user drags
+// or zooms, Render() only blits that bitmap translated and scaled by the
+// accumulated interaction; once no interaction happened for the idle delay,
+// the view is refreshed and the next Render() runs the full renderer again.
+//
+// The caller still applies the pan/zoom to its own model, so that the
+// renderer draws the right area once the interaction ends.
+class fxInteractionPreview : public wxEvtHandler
+{
+public:
+    explicit fxInteractionPreview(wxWindow* window = nullptr, int idleDelayMs = 150);
+    ~fxInteractionPreview() override;
+
+    void SetRenderer(fxViewRenderer renderer) { m_renderer = std::move(renderer); Invalidate(); }
+
+    // Time without interaction before the full-quality render (milliseconds)
+    void SetIdleDelay(int ms) { m_idleDelayMs = ms; }
+    int GetIdleDelay() const { return m_idleDelayMs; }
+
+    // Colour of areas uncovered by the preview
+    void SetBackground(const wxColour& colour) { m_background = colour; }
+
+    // Called when a repaint is needed; defaults to window->Refresh()
+    void SetRefreshCallback(std::function<void()> refresh) { m_refresh = std::move(refresh); }
+
+    //================================================
+    // Interaction, in device pixels
+    //================================================
+    void Pan(wxDouble dx, wxDouble dy);
+    void Zoom(wxDouble factor, const wxPoint2DDouble& center);
+
+    bool IsInteracting() const { return m_interacting; }
+
+    // Drop the cached frame: the next Render() is a full one
+    void Invalidate() { m_frameValid = false; }
+
+    //================================================
+    // Paint: preview while interacting, full render otherwise
+    //================================================
+    void Render(fxDrawingContext& ctx);
+
+private:
+    wxWindow*      m_window = nullptr;
+    fxViewRenderer m_renderer;
+    std::function<void()> m_refresh;
+    wxTimer        m_idleTimer;
+    int            m_idleDelayMs;
+    wxColour       m_background = *wxWHITE;
+
+    // Last full-quality frame
+    wxBitmap       m_frame;
+    bool           m_frameValid = false;
+
+    // Preview mapping from frame to screen: p' = m_scale * p + m_offset
+    wxDouble        m_scale = 1.0;
+    wxPoint2DDouble m_offset;
+    bool            m_interacting = false;
+
+    void Touch();
+    void RequestRefresh();
+    void RenderFrame(const wxSize& size);
+    void OnIdleTimer(wxTimerEvent& event);
+};
+
+#endif // FXINTERACTIONPREVIEW_HPP
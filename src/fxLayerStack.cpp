@@ -0,0 +1,111 @@
+// fxLayerStack.cpp
+#include "fxLayerStack.hpp"
+#include "fxTrace.hpp"
+#include <wx/image.h>
+#include <wx/graphics.h>
+#include <algorithm>
+#include <cstring>
+
+//--------------------------------------
+// Layer management
+//--------------------------------------
+fxLayer& fxLayerStack::AddLayer(const wxString& name, fxLayerPainter painter, bool cached)
+{
+    m_layers.push_back(std::make_unique<fxLayer>(name, std::move(painter), cached));
+    return *m_layers.back();
+}
+
+fxLayer* fxLayerStack::FindLayer(const wxString& name)
+{
+    for (auto& layer : m_layers) {
+        if (layer->GetName() == name) return layer.get();
+    }
+    return nullptr;
+}
+
+void fxLayerStack::RemoveLayer(const wxString& name)
+{
+    m_layers.erase(std::remove_if(m_layers.begin(), m_layers.end(),
+                                  [&](const std::unique_ptr<fxLayer>& l) { return l->GetName() == name; }),
+                   m_layers.end());
+}
+
+void fxLayerStack::InvalidateAll()
+{
+    for (auto& layer : m_layers) layer->Invalidate();
+}
+
+//--------------------------------------
+// Render: recompose all layers
+//--------------------------------------
+void fxLayerStack::Render(fxDrawingContext& ctx)
+{
+    if (!ctx.IsValid()) return;
+    FX_TRACE_SCOPE(Layer, "LayerStack::Render");
+
+    const wxSize size = ctx.GetSize();
+
+    for (auto& ptr : m_layers)
+    {
+        fxLayer& layer = *ptr;
+        if (!layer.m_visible || !layer.m_painter) continue;
+
+        if (!layer.m_cached) {
+            // Dynamic layer: draw straight on the target
+            layer.m_painter(ctx);
+            continue;
+        }
+
+        if (!layer.m_valid || layer.m_cachedSize != size) {
+            UpdateCache(layer, ctx, size);
+        }
+
+        if (ctx.IsRasterTarget() && layer.m_bitmap.IsOk()) {
+            ctx.DrawBitmap(layer.m_bitmap, 0, 0, size.GetWidth(), size.GetHeight());
+        } else {
+            // Vector targets keep the content as vector data
+            layer.m_displayList.Replay(ctx);
+        }
+    }
+}
+
+void fxLayerStack::UpdateCache(fxLayer& layer, fxDrawingContext& ctx, const wxSize& size)
+{
+    FX_TRACE_SCOPE(Layer, "LayerStack::UpdateCache");
+
+    // Record against the real target, so text extents are measured there
+    layer.m_displayList.Clear();
+    ctx.BeginRecording(&layer.m_displayList);
+    layer.m_painter(ctx);
+    ctx.EndRecording();
+
+    layer.m_bitmap = ctx.IsRasterTarget() ? RasterizeDisplayList(layer.m_displayList, size)
+                                          : wxBitmap();
+    layer.m_cachedSize = size;
+    layer.m_valid = true;
+}
+
+//--------------------------------------
+// Rasterize a display list with alpha
+//--------------------------------------
+wxBitmap RasterizeDisplayList(const fxDisplayList& list, const wxSize& size)
+{
+    if (size.GetWidth() <= 0 || size.GetHeight() <= 0) return wxBitmap();
+
+    // Fully transparent canvas
+    wxImage image(size.GetWidth(), size.GetHeight());
+    image.InitAlpha();
+    std::memset(image.GetAlpha(), 0, size_t(size.GetWidth()) * size.GetHeight());
+
+    // The image receives the drawing when the GC is destroyed
+    wxGraphicsContext* gc = wxGraphicsContext::Create(image);
+    if (!gc) return wxBitmap();
+    {
+        fxDrawingContext layerCtx(gc);
+        list.Replay(layerCtx);
+    }
+    delete gc;
+
+    FX_TRACE_SCOPE(Encode, "ImageToBitmap");
+    return wxBitmap(image, 32);
+}
@@ -0,0 +1,89 @@
+// fxLayerStack.hpp
+
+#ifndef FXLAYERSTACK_HPP
+#define FXLAYERSTACK_HPP
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include <wx/bitmap.h>
+#include "fxDrawingContext.hpp"
+#include "fxDisplayList.hpp"
+
+// Paints the content of one layer
+using fxLayerPainter = std::function<void(fxDrawingContext&)>;
+
+// A named drawing layer.
+// Cached layers record their painter once into a display list; on raster
+// targets the list is also rendered into a transparent bitmap. Both are
+// reused until the layer is invalidated or the target size changes.
+// Uncached layers (crosshair, live data) call their painter every frame.
+class fxLayer
+{
+public:
+    fxLayer(const wxString& name, fxLayerPainter painter, bool cached)
+        : m_name(name), m_painter(std::move(painter)), m_cached(cached) {}
+
+    const wxString& GetName() const { return m_name; }
+
+    bool IsCached() const { return m_cached; }
+    void SetCached(bool cached) { m_cached = cached; Invalidate(); }
+
+    bool IsVisible() const { return m_visible; }
+    void SetVisible(bool visible) { m_visible = visible; }
+
+    // Drop cached content: the painter runs again on next render
+    void Invalidate() { m_valid = false; }
+    bool IsValid() const { return m_valid; }
+
+    void SetPainter(fxLayerPainter painter) { m_painter = std::move(painter); Invalidate(); }
+
+private:
+    friend class fxLayerStack;
+
+    wxString       m_name;
+    fxLayerPainter m_painter;
+    bool           m_cached  = true;
+    bool           m_visible = true;
+    bool           m_valid   = false;
+
+    // Cache
+    fxDisplayList  m_displayList;
+    wxBitmap       m_bitmap;       // raster targets only
+    wxSize         m_cachedSize;
+};
+
+// Ordered stack of layers, composited bottom to top
+class fxLayerStack
+{
+public:
+    fxLayerStack() = default;
+
+    // Add a layer on top of the stack
+    fxLayer& AddLayer(const wxString& name, fxLayerPainter painter, bool cached = true);
+
+    // Find a layer by name (nullptr if not present)
+    fxLayer* FindLayer(const wxString& name);
+
+    size_t GetCount() const { return m_layers.size(); }
+    fxLayer& GetLayer(size_t index) { return *m_layers[index]; }
+
+    void RemoveLayer(const wxString& name);
+    void Clear() { m_layers.clear(); }
+
+    // Invalidate every cached layer (e.g. after a zoom or a theme change)
+    void InvalidateAll();
+
+    // Draw all visible layers on the given context
+    void Render(fxDrawingContext& ctx);
+
+private:
+    std::vector<std::unique_ptr<fxLayer>> m_layers;
+
+    void UpdateCache(fxLayer& layer, fxDrawingContext& ctx, const wxSize& size);
+};
+
+// Render a display list into a transparent bitmap of the given size
+wxBitmap RasterizeDisplayList(const fxDisplayList& list, const wxSize& size);
+
+#endif // FXLAYERSTACK_HPP
@@ -0,0 +1,158 @@
+// fxMappedFile.cpp
+#include "fxMappedFile.hpp"
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+fxMappedFile::fxMappedFile(fxMappedFile&& other) noexcept
+{
+    Swap(other);
+}
+
+fxMappedFile& fxMappedFile::operator=(fxMappedFile&& other) noexcept
+{
+    if (this != &other) {
+        Close();
+        Swap(other);
+    }
+    return *this;
+}
+
+void fxMappedFile::Swap(fxMappedFile& other) noexcept
+{
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_open, other.m_open);
+#ifdef _WIN32
+    std::swap(m_file, other.m_file);
+    std::swap(m_mapping, other.m_mapping);
+#endif
+}
+
+#ifdef _WIN32
+
+bool fxMappedFile::Open(const wxString& filename)
+{
+    Close();
+
+    HANDLE file = ::CreateFileW(filename.wc_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file, &size)) {
+        ::CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_size = static_cast<size_t>(size.QuadPart);
+    m_open = true;
+    if (m_size == 0) return true;  // nothing to map
+
+    HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        Close();
+        return false;
+    }
+    m_mapping = mapping;
+
+    m_data = static_cast<const char*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void fxMappedFile::Close()
+{
+    if (m_data) ::UnmapViewOfFile(m_data);
+    if (m_mapping) ::CloseHandle(static_cast<HANDLE>(m_mapping));
+    if (m_file) ::CloseHandle(static_cast<HANDLE>(m_file));
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+void fxMappedFile::Prefetch(size_t offset, size_t length) const
+{
+#if _WIN32_WINNT >= 0x0602
+    if (!m_data || offset >= m_size) return;
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<char*>(m_data + offset);
+    range.NumberOfBytes = std::min(length, m_size - offset);
+    ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
+#else
+    (void)offset;
+    (void)length;
+#endif
+}
+
+#else
+
+bool fxMappedFile::Open(const wxString& filename)
+{
+    Close();
+
+    const int fd = ::open(filename.fn_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    m_size = static_cast<size_t>(st.st_size);
+    m_open = true;
+
+    if (m_size > 0) {
+        void* p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            m_size = 0;
+            m_open = false;
+            return false;
+        }
+        m_data = static_cast<const char*>(p);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+    return true;
+}
+
+void fxMappedFile::Close()
+{
+    if (m_data) ::munmap(const_cast<char*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+void fxMappedFile::Prefetch(size_t offset, size_t length) const
+{
+    if (!m_data || offset >= m_size) return;
+    length = std::min(length, m_size - offset);
+
+    // madvise wants a page-aligned start
+    static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t start = offset - offset % page;
+    ::madvise(const_cast<char*>(m_data + start), length + (offset - start), MADV_WILLNEED);
+}
+
+#endif
@@ -0,0 +1,51 @@
+// fxMappedFile.hpp
+
+#ifndef FXMAPPEDFILE_HPP
+#define FXMAPPEDFILE_HPP
+
+#include <cstddef>
+#include <wx/string.h>
+
+// Read-only memory mapping of a whole file.
+// Uses mmap on POSIX systems and CreateFileMapping on Windows.
+// An empty file opens successfully with Data() == nullptr.
+class fxMappedFile
+{
+public:
+    fxMappedFile() = default;
+    explicit fxMappedFile(const wxString& filename) { Open(filename); }
+    ~fxMappedFile() { Close(); }
+
+    fxMappedFile(const fxMappedFile&) = delete;
+    fxMappedFile& operator=(const fxMappedFile&) = delete;
+
+    fxMappedFile(fxMappedFile&& other) noexcept;
+    fxMappedFile& operator=(fxMappedFile&& other) noexcept;
+
+    bool Open(const wxString& filename);
+    void Close();
+
+    bool IsOpen() const { return m_open; }
+    const char* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+
+    const char* begin() const { return m_data; }
+    const char* end() const { return m_data + m_size; }
+
+    // Hint that bytes [offset, offset + length) will be read soon, so that the
+    // system starts paging them in; no effect where unsupported
+    void Prefetch(size_t offset, size_t length) const;
+
+private:
+    const char* m_data = nullptr;
+    size_t      m_size = 0;
+    bool        m_open = false;
+#ifdef _WIN32
+    void*       m_file = nullptr;      // HANDLE
+    void*       m_mapping = nullptr;   // HANDLE
+#endif
+
+    void Swap(fxMappedFile& other) noexcept;
+};
+
+#endif // FXMAPPEDFILE_HPP
@@ -0,0 +1,168 @@
+// fxMappedSeries.cpp
+#include "fxMappedSeries.hpp"
+#include "fxTrace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+// Sample index at or after position p, within [0, n]
+uint64_t CeilIndex(double p, uint64_t n)
+{
+    const double c = std::ceil(p);
+    return !(c > 0.0) ? 0 : c >= double(n) ? n : uint64_t(c);
+}
+
+// Unaligned read (the header may have any length)
+template <typename T>
+double ReadSample(const char* base, uint64_t i)
+{
+    T v;
+    std::memcpy(&v, base + i * sizeof(T), sizeof(T));
+    return double(v);
+}
+
+} // namespace
+
+//--------------------------------------
+// File
+//--------------------------------------
+bool fxMappedSeries::Open(const wxString& filename, fxSampleFormat format, size_t headerBytes)
+{
+    Close();
+    if (!m_file.Open(filename)) return false;
+
+    m_format = format;
+    m_header = headerBytes;
+    m_count = m_file.Size() > headerBytes ? (m_file.Size() - headerBytes) / SampleBytes() : 0;
+    return true;
+}
+
+void fxMappedSeries::Close()
+{
+    m_file.Close();
+    m_header = 0;
+    m_count = 0;
+    m_hasLast = false;
+}
+
+size_t fxMappedSeries::SampleBytes() const
+{
+    switch (m_format) {
+    case fxSampleFormat::Int16:   return sizeof(int16_t);
+    case fxSampleFormat::Float32: return sizeof(float);
+    case fxSampleFormat::Float64: return sizeof(double);
+    }
+    return 1;
+}
+
+double fxMappedSeries::GetSample(uint64_t i) const
+{
+    const char* base = m_file.Data() + m_header;
+    switch (m_format) {
+    case fxSampleFormat::Int16:   return ReadSample<int16_t>(base, i);
+    case fxSampleFormat::Float32: return ReadSample<float>(base, i);
+    case fxSampleFormat::Float64: return ReadSample<double>(base, i);
+    }
+    return 0.0;
+}
+
+void fxMappedSeries::PrefetchChunks(uint64_t firstChunk, uint64_t chunks) const
+{
+    const uint64_t begin = firstChunk * m_chunkSamples;
+    if (chunks == 0 || begin >= m_count) return;
+    const uint64_t end = std::min(m_count, begin + chunks * m_chunkSamples);
+    m_file.Prefetch(m_header + size_t(begin) * SampleBytes(), size_t(end - begin) * SampleBytes());
+}
+
+//--------------------------------------
+// Decimation
+//--------------------------------------
+fxGraphicsPath fxMappedSeries::ToPath(double xMin, double xMax, size_t columns)
+{
+    fxGraphicsPath path;
+    if (m_count == 0 || columns == 0 || !(xMax > xMin) || !(m_dx > 0.0)) return path;
+    FX_TRACE_SCOPE(Path, "MappedSeries");
+
+    switch (m_format) {
+    case fxSampleFormat::Int16:   Decimate<int16_t>(path, xMin, xMax, columns); break;
+    case fxSampleFormat::Float32: Decimate<float>(path, xMin, xMax, columns); break;
+    case fxSampleFormat::Float64: Decimate<double>(path, xMin, xMax, columns); break;
+    }
+
+    // Read ahead in the direction of the pan (both ways until it is known)
+    const uint64_t first = CeilIndex((xMin - m_x0) / m_dx, m_count);
+    const uint64_t last = CeilIndex((xMax - m_x0) / m_dx, m_count);
+    const uint64_t firstChunk = first / m_chunkSamples;
+    const uint64_t lastChunk = last / m_chunkSamples;
+    if (!m_hasLast || first >= m_lastFirst) PrefetchChunks(lastChunk + 1, m_prefetchChunks);
+    if (!m_hasLast || first <= m_lastFirst) {
+        const uint64_t chunks = std::min<uint64_t>(firstChunk, m_prefetchChunks);
+        PrefetchChunks(firstChunk - chunks, chunks);
+    }
+    m_lastFirst = first;
+    m_hasLast = true;
+    return path;
+}
+
+template <typename T>
+void fxMappedSeries::Decimate(fxGraphicsPath& path, double xMin, double xMax, size_t columns) const
+{
+    const char* base = m_file.Data() + m_header;
+    const double first = (xMin - m_x0) / m_dx;
+    const double last = (xMax - m_x0) / m_dx;
+    const double perColumn = (last - first) / columns;
+
+    // Samples only move forward: on entering a chunk, announce the next one
+    uint64_t chunkEnd = 0;
+    auto enter = [&](uint64_t sample) {
+        const uint64_t next = sample / m_chunkSamples + 1;
+        PrefetchChunks(next, 1);
+        chunkEnd = next * m_chunkSamples;
+    };
+
+    bool drawing = false;
+    auto add = [&](double x, double y) {
+        if (drawing) path.AddLineToPoint(x, y);
+        else path.MoveToPoint(x, y);
+        drawing = true;
+    };
+
+    if (perColumn < 2.0) {
+        const uint64_t s0 = CeilIndex(first - 1.0, m_count);
+        const uint64_t s1 = CeilIndex(last + 1.0, m_count);
+        for (uint64_t s = s0; s < s1; ++s) {
+            if (s >= chunkEnd) enter(s);
+            const double v = ReadSample<T>(base, s);
+            if (std::isnan(v)) { drawing = false; continue; }
+            add(m_x0 + s * m_dx, v);
+        }
+        return;
+    }
+
+    const double columnWidth = (xMax - xMin) / columns;
+    double previous = 0.0;      // last y added
+    for (size_t c = 0; c < columns; ++c) {
+        const uint64_t s0 = CeilIndex(first + c * perColumn, m_count);
+        const uint64_t s1 = CeilIndex(c + 1 == columns ? last : first + (c + 1) * perColumn, m_count);
+
+        double lo = std::numeric_limits<double>::infinity(), hi = -lo;
+        for (uint64_t s = s0; s < s1; ++s) {
+            if (s >= chunkEnd) enter(s);
+            const double v = ReadSample<T>(base, s);
+            if (v < lo) lo = v;
+            if (v > hi) hi = v;
+        }
+        // Empty, or only NaN samples
+        if (lo > hi) { drawing = false; continue; }
+
+        // Start from the end nearer the previous column
+        const double x = xMin + (c + 0.5) * columnWidth;
+        const bool highFirst = drawing && std::abs(previous - hi) < std::abs(previous - lo);
+        add(x, highFirst ? hi : lo);
+        add(x, highFirst ? lo : hi);
+        previous = highFirst ? lo : hi;
+    }
+}
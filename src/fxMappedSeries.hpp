@@ -0,0 +1,80 @@
+// fxMappedSeries.hpp
+
+#ifndef FXMAPPEDSERIES_HPP
+#define FXMAPPEDSERIES_HPP
+
+#include <cstdint>
+#include <wx/string.h>
+#include "fxGraphicsPath.hpp"
+#include "fxMappedFile.hpp"
+
+// Binary sample layouts (native byte order)
+enum class fxSampleFormat
+{
+    Int16 = 0,
+    Float32,
+    Float64
+};
+
+// Uniformly sampled series read straight from a memory-mapped binary file.
+//
+// Nothing is loaded up front: the file is mapped, and drawing a view walks
+// only the samples in the visible range, chunk by chunk, decimating them to
+// one min/max pair per pixel column as it goes. While a chunk is scanned the
+// next ones are announced to the system (madvise), and after each view the
+// chunks beyond it in the direction of the last pan are prefetched too, so
+// panning rarely waits on the disk. This plots files bigger than memory; the
+// pages stay under the control of the system cache.
+//
+// For repeated zooming over the whole of a huge file, build an
+// fxMinMaxPyramid once instead of rescanning it at every frame.
+class fxMappedSeries
+{
+public:
+    static const size_t DEFAULT_CHUNK_SAMPLES = 1 << 20;
+
+    fxMappedSeries() = default;
+
+    // Samples start headerBytes into the file; a trailing partial sample is ignored
+    bool Open(const wxString& filename, fxSampleFormat format, size_t headerBytes = 0);
+    void Close();
+
+    bool IsOpen() const { return m_file.IsOpen(); }
+    fxSampleFormat GetFormat() const { return m_format; }
+    uint64_t GetSampleCount() const { return m_count; }
+    double GetSample(uint64_t i) const;
+
+    // Sample i is at x = x0 + i * dx
+    void SetSampling(double x0, double dx) { m_x0 = x0; m_dx = dx; }
+
+    // Prefetch granularity, and how many chunks to prefetch ahead
+    void SetChunkSamples(size_t samples) { m_chunkSamples = samples > 0 ? samples : 1; }
+    void SetPrefetchChunks(size_t chunks) { m_prefetchChunks = chunks; }
+
+    // The series between xMin and xMax, in data coordinates, decimated for
+    // columns pixel columns: a vertical min/max stroke per column, or the
+    // samples themselves (one more on each side) when there are fewer than
+    // two per column. NaN samples break the line.
+    fxGraphicsPath ToPath(double xMin, double xMax, size_t columns);
+
+private:
+    fxMappedFile   m_file;
+    fxSampleFormat m_format = fxSampleFormat::Float32;
+    size_t         m_header = 0;
+    uint64_t       m_count = 0;
+    double         m_x0 = 0.0;
+    double         m_dx = 1.0;
+
+    size_t   m_chunkSamples = DEFAULT_CHUNK_SAMPLES;
+    size_t   m_prefetchChunks = 2;
+    uint64_t m_lastFirst = 0;      // first sample of the previous view
+    bool     m_hasLast = false;
+
+    size_t SampleBytes() const;
+    void PrefetchChunks(uint64_t firstChunk, uint64_t chunks) const;
+
+    template <typename T>
+    void Decimate(fxGraphicsPath& path, double xMin, double xMax, size_t columns) const;
+};
+
+#endif // FXMAPPEDSERIES_HPP
@@ -0,0 +1,229 @@
+// fxMinMaxPyramid.cpp
+#include "fxMinMaxPyramid.hpp"
+#include "fxParallel.hpp"
+#include "fxTrace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Buckets filled per task at least
+const size_t MIN_BUCKETS_PER_TASK = 1 << 16;
+
+// Empty bucket: above every value for the minimum, below for the maximum
+template <typename T>
+T Highest()
+{
+    return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                : std::numeric_limits<T>::max();
+}
+
+template <typename T>
+T Lowest()
+{
+    return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                : std::numeric_limits<T>::lowest();
+}
+
+// Sample index at or after position p, within [0, n]
+uint64_t CeilIndex(double p, uint64_t n)
+{
+    const double c = std::ceil(p);
+    return !(c > 0.0) ? 0 : c >= double(n) ? n : uint64_t(c);
+}
+
+} // namespace
+
+//--------------------------------------
+// Build
+//--------------------------------------
+template <typename T>
+void fxMinMaxPyramid<T>::Clear()
+{
+    m_samples = nullptr;
+    m_count = 0;
+    m_min.clear();
+    m_max.clear();
+}
+
+template <typename T>
+void fxMinMaxPyramid<T>::Build(const T* samples, uint64_t n)
+{
+    Clear();
+    if (!samples || n == 0) return;
+    FX_TRACE_SCOPE(Encode, "PyramidBuild");
+
+    m_samples = samples;
+    m_count = n;
+
+    size_t buckets = size_t((n + BASE_BUCKET - 1) >> BASE_SHIFT);
+    for (;;) {
+        m_min.emplace_back(buckets);
+        m_max.emplace_back(buckets);
+        const size_t level = m_min.size() - 1;
+        T* mins = m_min[level].data();
+        T* maxs = m_max[level].data();
+
+        if (level == 0) {
+            // From the samples; comparisons skip NaN
+            fxParallelFor(buckets, MIN_BUCKETS_PER_TASK, [&](size_t begin, size_t end) {
+                for (size_t b = begin; b < end; ++b) {
+                    const uint64_t s0 = uint64_t(b) << BASE_SHIFT;
+                    const uint64_t s1 = std::min(n, s0 + BASE_BUCKET);
+                    T lo = Highest<T>(), hi = Lowest<T>();
+                    for (uint64_t s = s0; s < s1; ++s) {
+                        const T v = samples[s];
+                        if (v < lo) lo = v;
+                        if (v > hi) hi = v;
+                    }
+                    mins[b] = lo;
+                    maxs[b] = hi;
+                }
+            });
+        } else {
+            // Pairs of the level below (the last bucket may be alone)
+            const T* lowerMins = m_min[level - 1].data();
+            const T* lowerMaxs = m_max[level - 1].data();
+            const size_t lower = m_min[level - 1].size();
+            fxParallelFor(buckets, MIN_BUCKETS_PER_TASK, [&](size_t begin, size_t end) {
+                for (size_t b = begin; b < end; ++b) {
+                    const size_t k = 2 * b;
+                    mins[b] = k + 1 < lower ? std::min(lowerMins[k], lowerMins[k + 1]) : lowerMins[k];
+                    maxs[b] = k + 1 < lower ? std::max(lowerMaxs[k], lowerMaxs[k + 1]) : lowerMaxs[k];
+                }
+            });
+        }
+
+        if (buckets == 1) break;
+        buckets = (buckets + 1) / 2;
+    }
+}
+
+template <typename T>
+size_t fxMinMaxPyramid<T>::GetBytes() const
+{
+    size_t bytes = 0;
+    for (const auto& level : m_min) bytes += 2 * level.size() * sizeof(T);
+    return bytes;
+}
+
+//--------------------------------------
+// Queries
+//--------------------------------------
+template <typename T>
+void fxMinMaxPyramid<T>::Envelope(double first, double last, size_t columns, double* mins, double* maxs) const
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double perColumn = columns > 0 ? (last - first) / columns : 0.0;
+    if (m_count == 0 || !(perColumn > 0.0)) {
+        std::fill(mins, mins + columns, nan);
+        std::fill(maxs, maxs + columns, nan);
+        return;
+    }
+
+    // Coarsest level whose buckets are no wider than a column (-1: the samples)
+    int level = -1;
+    if (perColumn >= double(BASE_BUCKET)) {
+        level = std::min(std::ilogb(perColumn) - int(BASE_SHIFT), int(m_min.size()) - 1);
+    }
+
+    for (size_t c = 0; c < columns; ++c) {
+        const uint64_t s0 = CeilIndex(first + c * perColumn, m_count);
+        const uint64_t s1 = CeilIndex(c + 1 == columns ? last : first + (c + 1) * perColumn, m_count);
+
+        T lo = Highest<T>(), hi = Lowest<T>();
+        if (s0 < s1) {
+            if (level < 0) {
+                for (uint64_t s = s0; s < s1; ++s) {
+                    const T v = m_samples[s];
+                    if (v < lo) lo = v;
+                    if (v > hi) hi = v;
+                }
+            } else {
+                const unsigned shift = BASE_SHIFT + unsigned(level);
+                const T* levelMins = m_min[level].data();
+                const T* levelMaxs = m_max[level].data();
+                const size_t k1 = size_t((s1 - 1) >> shift);
+                for (size_t k = size_t(s0 >> shift); k <= k1; ++k) {
+                    lo = std::min(lo, levelMins[k]);
+                    hi = std::max(hi, levelMaxs[k]);
+                }
+            }
+        }
+
+        // Empty, or only NaN samples
+        if (lo > hi) {
+            mins[c] = maxs[c] = nan;
+        } else {
+            mins[c] = double(lo);
+            maxs[c] = double(hi);
+        }
+    }
+}
+
+//--------------------------------------
+// Draw
+//--------------------------------------
+template <typename T>
+void fxMinMaxPyramid<T>::Draw(fxDrawingContext& ctx, const wxRect2DDouble& view,
+                              wxDouble x, wxDouble y, wxDouble w, wxDouble h) const
+{
+    if (m_count == 0 || !(w > 0.0) || !(h > 0.0) || !(view.m_width > 0.0) || !(view.m_height > 0.0) ||
+        !(m_dx > 0.0)) {
+        return;
+    }
+    FX_TRACE_SCOPE(Path, "MinMaxPyramid");
+
+    const double first = (view.m_x - m_x0) / m_dx;
+    const double last = (view.m_x + view.m_width - m_x0) / m_dx;
+    const size_t columns = size_t(std::ceil(w));
+
+    const double top = view.m_y + view.m_height;
+    const double sy = h / view.m_height;
+
+    // Runs are broken by gaps (NaN)
+    std::vector<wxPoint2DDouble> points;
+    auto flush = [&]() {
+        if (points.size() >= 2) ctx.StrokeLines(points.size(), points.data());
+        points.clear();
+    };
+
+    if ((last - first) / columns < 2.0) {
+        // The samples, with one more on each side so that the line reaches the edges
+        const double sx = w / (last - first);
+        const uint64_t s0 = CeilIndex(first - 1.0, m_count);
+        const uint64_t s1 = CeilIndex(last + 1.0, m_count);
+        points.reserve(size_t(s1 - s0));
+        for (uint64_t s = s0; s < s1; ++s) {
+            const double v = double(m_samples[s]);
+            if (std::isnan(v)) { flush(); continue; }
+            points.emplace_back(x + (s - first) * sx, y + (top - v) * sy);
+        }
+    } else {
+        std::vector<double> mins(columns), maxs(columns);
+        Envelope(first, last, columns, mins.data(), maxs.data());
+
+        const double columnWidth = w / columns;
+        points.reserve(2 * columns);
+        for (size_t c = 0; c < columns; ++c) {
+            if (std::isnan(mins[c])) { flush(); continue; }
+            const double cx = x + (c + 0.5) * columnWidth;
+            const double yLow = y + (top - mins[c]) * sy;
+            const double yHigh = y + (top - maxs[c]) * sy;
+            // Start from the end nearer the previous column
+            if (!points.empty() && std::abs(points.back().m_y - yHigh) < std::abs(points.back().m_y - yLow)) {
+                points.emplace_back(cx, yHigh);
+                points.emplace_back(cx, yLow);
+            } else {
+                points.emplace_back(cx, yLow);
+                points.emplace_back(cx, yHigh);
+            }
+        }
+    }
+    flush();
+}
+
+template class fxMinMaxPyramid<float>;
+template class fxMinMaxPyramid<double>;
+template class fxMinMaxPyramid<int16_t>;
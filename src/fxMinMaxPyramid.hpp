@@ -0,0 +1,67 @@
+// fxMinMaxPyramid.hpp
+
+#ifndef FXMINMAXPYRAMID_HPP
+#define FXMINMAXPYRAMID_HPP
+
+#include <cstdint>
+#include <vector>
+#include <wx/geometry.h>
+#include "fxDrawingContext.hpp"
+
+// Level-of-detail pyramid over a uniformly sampled series.
+//
+// Level k holds the minimum and maximum of every run of 2^k samples, each
+// level halving the previous one; the finest level stored has buckets of
+// BASE_BUCKET samples, below that the samples themselves are read. Built once
+// (in parallel), the pyramid lets any zoom be drawn by reading only the visible
+// range from the level closest to the pixel density, so the cost follows the
+// number of pixel columns rather than the number of samples. The levels take
+// 4 / BASE_BUCKET times the size of the data, so as much again.
+//
+// The samples are not copied: they must stay valid and unchanged while the
+// pyramid is used. Instantiated for float, double and int16_t; NaN samples
+// are skipped.
+template <typename T>
+class fxMinMaxPyramid
+{
+public:
+    static constexpr unsigned BASE_SHIFT = 2;
+    static constexpr uint64_t BASE_BUCKET = uint64_t(1) << BASE_SHIFT;
+
+    fxMinMaxPyramid() = default;
+
+    // Index the samples (replaces the previous series)
+    void Build(const T* samples, uint64_t n);
+    void Clear();
+
+    uint64_t GetSampleCount() const { return m_count; }
+    size_t GetLevelCount() const { return m_min.size(); }
+    size_t GetBytes() const;
+
+    // Sample i is at x = x0 + i * dx
+    void SetSampling(double x0, double dx) { m_x0 = x0; m_dx = dx; }
+
+    // Min/max of the samples in each of columns equal slices of the sample
+    // positions [first, last); columns without samples get NaN. Bucket edges
+    // may widen a column by less than its width on each side.
+    void Envelope(double first, double last, size_t columns, double* mins, double* maxs) const;
+
+    // Stroke the part of the series inside view (data coordinates, y up) into
+    // the device rectangle with the current pen: one vertical min/max stroke
+    // per pixel column, or the samples themselves when zoomed in closer than
+    // two samples per column. The line is not clipped to the rectangle.
+    void Draw(fxDrawingContext& ctx, const wxRect2DDouble& view,
+              wxDouble x, wxDouble y, wxDouble w, wxDouble h) const;
+
+private:
+    const T* m_samples = nullptr;
+    uint64_t m_count = 0;
+    double   m_x0 = 0.0;
+    double   m_dx = 1.0;
+
+    // m_min[i], m_max[i]: buckets of 2^(BASE_SHIFT + i) samples
+    std::vector<std::vector<T>> m_min;
+    std::vector<std::vector<T>> m_max;
+};
+
+#endif // FXMINMAXPYRAMID_HPP
@@ -0,0 +1,78 @@
+// fxParallel.hpp
+
+#ifndef FXPARALLEL_HPP
+#define FXPARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Minimal fork/join helpers for data-parallel loops.
+// Worker threads are started per call, so the work should be coarse
+// (at least a few hundred microseconds per task).
+
+// Number of threads worth starting for the given number of tasks
+inline size_t fxParallelThreads(size_t tasks)
+{
+    const size_t hw = std::max<unsigned>(1, std::thread::hardware_concurrency());
+    return std::max<size_t>(1, std::min(hw, tasks));
+}
+
+// Call fn(i) for every i in [0, tasks), in any order and on any thread.
+// The calling thread takes part; the first exception thrown is rethrown.
+template <typename F>
+void fxParallelForEach(size_t tasks, F&& fn)
+{
+    const size_t threads = fxParallelThreads(tasks);
+    if (threads <= 1) {
+        for (size_t i = 0; i < tasks; ++i) fn(i);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < tasks; i = next++) {
+            try {
+                fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+
+    if (error) std::rethrow_exception(error);
+}
+
+// Call fn(begin, end) on contiguous ranges covering [0, count),
+// each at least minPerTask long (except the last one)
+template <typename F>
+void fxParallelFor(size_t count, size_t minPerTask, F&& fn)
+{
+    if (count == 0) return;
+    minPerTask = std::max<size_t>(1, minPerTask);
+
+    const size_t tasks = fxParallelThreads(std::max<size_t>(1, count / minPerTask));
+    const size_t step  = (count + tasks - 1) / tasks;
+
+    fxParallelForEach(tasks, [&](size_t t) {
+        const size_t begin = t * step;
+        const size_t end   = std::min(count, begin + step);
+        if (begin < end) fn(begin, end);
+    });
+}
+
+#endif // FXPARALLEL_HPP
@@ -0,0 +1,25 @@
+// fxPathView.cpp
+#include "fxPathView.hpp"
+#include <utility>
+#include <vector>
+
+fxGraphicsPath fxPathView::ToPath() const
+{
+    fxGraphicsPath path;
+    if (m_size == 0) return path;
+
+    wxPoint2DDouble start;
+    std::vector<wxPoint2DDouble> rest;
+    rest.reserve(m_size - 1);
+    bool first = true;
+    ForEach([&](const wxPoint2DDouble& p) {
+        if (first) start = p;
+        else rest.push_back(p);
+        first = false;
+    });
+
+    path.MoveToPoint(start);
+    path.AddPolyline(std::move(rest));
+    if (m_closed) path.CloseSubpath();
+    return path;
+}
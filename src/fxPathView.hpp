@@ -0,0 +1,81 @@
+// fxPathView.hpp
+
+#ifndef FXPATHVIEW_HPP
+#define FXPATHVIEW_HPP
+
+#include <cstddef>
+#include <wx/geometry.h>
+#include "fxGraphicsPath.hpp"
+
+// Non-owning view of a polyline stored elsewhere.
+//
+// The coordinates stay in the caller's buffer: interleaved (x0, y0, x1, y1,
+// ...) or split into x and y arrays, in double or float. fxDrawingContext
+// draws, fills and strokes a view by reading the buffer directly, without
+// building fxGraphicsPath segments; only recording into a display list takes
+// a copy (ToPath), since the list outlives the call. The buffer must stay
+// valid and unchanged while the view is drawn.
+class fxPathView
+{
+public:
+    fxPathView() = default;
+
+    // Interleaved
+    fxPathView(const wxPoint2DDouble* points, size_t n, bool closed = false)
+        : fxPathView(&points->m_x, &points->m_y, n, 2, false, closed)
+    {
+        static_assert(sizeof(wxPoint2DDouble) == 2 * sizeof(double), "wxPoint2DDouble must be two packed doubles");
+    }
+    fxPathView(const double* xy, size_t n, bool closed = false) : fxPathView(xy, xy + 1, n, 2, false, closed) {}
+    fxPathView(const float* xy, size_t n, bool closed = false) : fxPathView(xy, xy + 1, n, 2, true, closed) {}
+
+    // Split
+    fxPathView(const double* x, const double* y, size_t n, bool closed = false) : fxPathView(x, y, n, 1, false, closed) {}
+    fxPathView(const float* x, const float* y, size_t n, bool closed = false) : fxPathView(x, y, n, 1, true, closed) {}
+
+    size_t GetSize() const { return m_size; }
+    bool IsEmpty() const { return m_size == 0; }
+    bool IsClosed() const { return m_closed; }
+
+    wxPoint2DDouble operator[](size_t i) const
+    {
+        return m_float ? wxPoint2DDouble(static_cast<const float*>(m_x)[i * m_stride],
+                                         static_cast<const float*>(m_y)[i * m_stride])
+                       : wxPoint2DDouble(static_cast<const double*>(m_x)[i * m_stride],
+                                         static_cast<const double*>(m_y)[i * m_stride]);
+    }
+
+    // Call fn(const wxPoint2DDouble&) for every point in order
+    template <typename F>
+    void ForEach(F&& fn) const
+    {
+        if (m_float) ForEachImpl<float>(fn);
+        else ForEachImpl<double>(fn);
+    }
+
+    // Owned copy: MoveTo, one Polyline segment, and Close for closed views
+    fxGraphicsPath ToPath() const;
+
+private:
+    const void* m_x = nullptr;
+    const void* m_y = nullptr;
+    size_t m_size = 0;
+    size_t m_stride = 1;    // in coordinates
+    bool   m_float = false;
+    bool   m_closed = false;
+
+    fxPathView(const void* x, const void* y, size_t n, size_t stride, bool isFloat, bool closed)
+        : m_x(x), m_y(y), m_size(n), m_stride(stride), m_float(isFloat), m_closed(closed)
+    {
+    }
+
+    template <typename T, typename F>
+    void ForEachImpl(F& fn) const
+    {
+        const T* x = static_cast<const T*>(m_x);
+        const T* y = static_cast<const T*>(m_y);
+        for (size_t i = 0; i < m_size; ++i) fn(wxPoint2DDouble(x[i * m_stride], y[i * m_stride]));
+    }
+};
+
+#endif // FXPATHVIEW_HPP
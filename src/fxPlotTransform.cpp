@@ -0,0 +1,330 @@
+// fxPlotTransform.cpp
+#include "fxPlotTransform.hpp"
+#include "fxSimd.hpp"
+#include "fxTrace.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Points mapped per block (kept in the cache between the passes)
+const size_t CHUNK = 256;
+
+const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+double Log10OrNaN(double v)
+{
+    return v > 0.0 ? std::log10(v) : NaN;
+}
+
+#if FX_SIMD_AVX2
+
+// Largest angle reduced by the vector sin/cos (the Cody-Waite split of pi/2
+// stays exact up to 2^20 quadrants); larger ones take the scalar path
+const double MAX_VECTOR_ANGLE = 1e5;
+
+FX_TARGET_AVX2
+bool AllNormalPositive(__m256d v)
+{
+    const __m256d ok = _mm256_and_pd(_mm256_cmp_pd(v, _mm256_set1_pd(DBL_MIN), _CMP_GE_OQ),
+                                     _mm256_cmp_pd(v, _mm256_set1_pd(DBL_MAX), _CMP_LE_OQ));
+    return _mm256_movemask_pd(ok) == 0xF;
+}
+
+FX_TARGET_AVX2
+bool AllVectorAngles(__m256d v)
+{
+    const __m256d a = _mm256_andnot_pd(_mm256_set1_pd(-0.0), v);
+    return _mm256_movemask_pd(_mm256_cmp_pd(a, _mm256_set1_pd(MAX_VECTOR_ANGLE), _CMP_LE_OQ)) == 0xF;
+}
+
+// log10 of normal positive values: v = m 2^e with m in [sqrt(1/2), sqrt(2)),
+// ln(m) = 2 atanh(f) with f = (m - 1) / (m + 1), |f| < 0.1716
+FX_TARGET_AVX2
+__m256d Log10x4(__m256d v)
+{
+    const __m256i bits = _mm256_castpd_si256(v);
+    const __m256i biased = _mm256_srli_epi64(bits, 52);
+    // Small integer to double: add it to the mantissa of 2^52
+    __m256d e = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(biased, _mm256_set1_epi64x(0x4330000000000000LL))),
+                              _mm256_set1_pd(4503599627370496.0 + 1023.0));
+    __m256d m = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+                                                    _mm256_set1_epi64x(0x3FF0000000000000LL)));
+    const __m256d big = _mm256_cmp_pd(m, _mm256_set1_pd(M_SQRT2), _CMP_GT_OQ);
+    m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), big);
+    e = _mm256_add_pd(e, _mm256_and_pd(big, _mm256_set1_pd(1.0)));
+
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d f = _mm256_div_pd(_mm256_sub_pd(m, one), _mm256_add_pd(m, one));
+    const __m256d f2 = _mm256_mul_pd(f, f);
+    __m256d p = _mm256_set1_pd(1.0 / 21);
+    for (int k = 19; k >= 1; k -= 2) p = _mm256_add_pd(_mm256_mul_pd(p, f2), _mm256_set1_pd(1.0 / k));
+    const __m256d lnm = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), f), p);
+
+    const __m256d ln = _mm256_add_pd(_mm256_mul_pd(e, _mm256_set1_pd(M_LN2)), lnm);
+    return _mm256_mul_pd(ln, _mm256_set1_pd(1.0 / M_LN10));
+}
+
+// sin and cos of |t| <= MAX_VECTOR_ANGLE: reduction to [-pi/4, pi/4] and the
+// fdlibm kernel polynomials
+FX_TARGET_AVX2
+void SinCosx4(__m256d t, __m256d& sinT, __m256d& cosT)
+{
+    const __m256d k = _mm256_round_pd(_mm256_mul_pd(t, _mm256_set1_pd(M_2_PI)),
+                                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d r = _mm256_sub_pd(t, _mm256_mul_pd(k, _mm256_set1_pd(1.57079632673412561417e+00)));
+    r = _mm256_sub_pd(r, _mm256_mul_pd(k, _mm256_set1_pd(6.07710050650619224932e-11)));
+    r = _mm256_sub_pd(r, _mm256_mul_pd(k, _mm256_set1_pd(2.02226624879595063154e-21)));
+    const __m256d r2 = _mm256_mul_pd(r, r);
+
+    __m256d s = _mm256_set1_pd(1.58969099521155010221e-10);
+    s = _mm256_add_pd(_mm256_mul_pd(s, r2), _mm256_set1_pd(-2.50507602534068634195e-08));
+    s = _mm256_add_pd(_mm256_mul_pd(s, r2), _mm256_set1_pd(2.75573137070700676789e-06));
+    s = _mm256_add_pd(_mm256_mul_pd(s, r2), _mm256_set1_pd(-1.98412698298579493134e-04));
+    s = _mm256_add_pd(_mm256_mul_pd(s, r2), _mm256_set1_pd(8.33333333332248946124e-03));
+    s = _mm256_add_pd(_mm256_mul_pd(s, r2), _mm256_set1_pd(-1.66666666666666324348e-01));
+    s = _mm256_add_pd(r, _mm256_mul_pd(_mm256_mul_pd(r, r2), s));
+
+    __m256d c = _mm256_set1_pd(-1.13596475577881948265e-11);
+    c = _mm256_add_pd(_mm256_mul_pd(c, r2), _mm256_set1_pd(2.08757232129817482790e-09));
+    c = _mm256_add_pd(_mm256_mul_pd(c, r2), _mm256_set1_pd(-2.75573143513906633035e-07));
+    c = _mm256_add_pd(_mm256_mul_pd(c, r2), _mm256_set1_pd(2.48015872894767294178e-05));
+    c = _mm256_add_pd(_mm256_mul_pd(c, r2), _mm256_set1_pd(-1.38888888888741095749e-03));
+    c = _mm256_add_pd(_mm256_mul_pd(c, r2), _mm256_set1_pd(4.16666666666666019037e-02));
+    c = _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(_mm256_set1_pd(0.5), r2)),
+                      _mm256_mul_pd(_mm256_mul_pd(r2, r2), c));
+
+    // Quadrant: swap on odd, sin negative in 2 and 3, cos negative in 1 and 2
+    const __m256i q = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(k));
+    const __m256i one = _mm256_set1_epi64x(1), two = _mm256_set1_epi64x(2);
+    const __m256d swap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(q, one), one));
+    const __m256d sinNeg = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(q, two), two));
+    const __m256d cosNeg = _mm256_castsi256_pd(
+        _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_add_epi64(q, one), two), two));
+    const __m256d sign = _mm256_set1_pd(-0.0);
+
+    sinT = _mm256_xor_pd(_mm256_blendv_pd(s, c, swap), _mm256_and_pd(sinNeg, sign));
+    cosT = _mm256_xor_pd(_mm256_blendv_pd(c, s, swap), _mm256_and_pd(cosNeg, sign));
+}
+
+// Coefficients of fxPlotTransform for the vector kernel
+struct VectorMapping
+{
+    double ax, bx, ay, by;
+    bool   xLog, yLog;
+    bool   polar, radialLog;
+    double radialOrigin;
+};
+
+// AVX2 part of MapBlock: whole groups of 4 points, returns the count done.
+// Groups the vector code can't take go through scalar(k) point by point.
+template <typename Scalar>
+FX_TARGET_AVX2
+size_t MapBlockAVX2(const VectorMapping& m, const double* u, const double* v, size_t n,
+                    double* x, double* y, Scalar&& scalar)
+{
+    const __m256d ax = _mm256_set1_pd(m.ax), bx = _mm256_set1_pd(m.bx);
+    const __m256d ay = _mm256_set1_pd(m.ay), by = _mm256_set1_pd(m.by);
+    const __m256d nan = _mm256_set1_pd(NaN);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d a = _mm256_loadu_pd(u + i);
+        __m256d b = _mm256_loadu_pd(v + i);
+        __m256d px, py;
+
+        if (m.polar) {
+            // Lanes the vector code can't take (non-positive or special
+            // values, huge angles) go through the scalar path
+            if ((m.radialLog && !AllNormalPositive(a)) || !AllVectorAngles(b)) {
+                for (size_t k = i; k < i + 4; ++k) scalar(k);
+                continue;
+            }
+            const __m256d rho = _mm256_sub_pd(m.radialLog ? Log10x4(a) : a, _mm256_set1_pd(m.radialOrigin));
+            __m256d s, c;
+            SinCosx4(b, s, c);
+            px = _mm256_add_pd(_mm256_mul_pd(ax, _mm256_mul_pd(rho, c)), bx);
+            py = _mm256_add_pd(_mm256_mul_pd(ay, _mm256_mul_pd(rho, s)), by);
+            const __m256d inside = _mm256_cmp_pd(rho, _mm256_setzero_pd(), _CMP_GE_OQ);
+            px = _mm256_blendv_pd(nan, px, inside);
+            py = _mm256_blendv_pd(nan, py, inside);
+        } else {
+            if ((m.xLog && !AllNormalPositive(a)) || (m.yLog && !AllNormalPositive(b))) {
+                for (size_t k = i; k < i + 4; ++k) scalar(k);
+                continue;
+            }
+            if (m.xLog) a = Log10x4(a);
+            if (m.yLog) b = Log10x4(b);
+            px = _mm256_add_pd(_mm256_mul_pd(ax, a), bx);
+            py = _mm256_add_pd(_mm256_mul_pd(ay, b), by);
+        }
+
+        // A point is either whole or NaN
+        const __m256d missing = _mm256_cmp_pd(px, py, _CMP_UNORD_Q);
+        _mm256_storeu_pd(x + i, _mm256_blendv_pd(px, nan, missing));
+        _mm256_storeu_pd(y + i, _mm256_blendv_pd(py, nan, missing));
+    }
+    return i;
+}
+
+#endif
+
+// Segment bounding box meets the rectangle
+bool SegmentMayCross(double x0, double y0, double x1, double y1, const wxRect2DDouble& clip)
+{
+    return std::max(x0, x1) >= clip.m_x && std::min(x0, x1) <= clip.m_x + clip.m_width &&
+           std::max(y0, y1) >= clip.m_y && std::min(y0, y1) <= clip.m_y + clip.m_height;
+}
+
+} // namespace
+
+//--------------------------------------
+// Setup
+//--------------------------------------
+fxPlotTransform::Axis fxPlotTransform::MakeAxis(fxAxisScale scale, double dataMin, double dataMax,
+                                                double deviceMin, double deviceMax)
+{
+    Axis axis;
+    axis.log = scale == fxAxisScale::Log10;
+    const double lo = axis.log ? Log10OrNaN(dataMin) : dataMin;
+    const double hi = axis.log ? Log10OrNaN(dataMax) : dataMax;
+    // A degenerate range maps everything to the start of the device range
+    axis.a = hi != lo && std::isfinite(hi - lo) ? (deviceMax - deviceMin) / (hi - lo) : 0.0;
+    axis.b = deviceMin - axis.a * (std::isfinite(lo) ? lo : 0.0);
+    return axis;
+}
+
+void fxPlotTransform::SetXAxis(fxAxisScale scale, double dataMin, double dataMax, double deviceMin, double deviceMax)
+{
+    m_x = MakeAxis(scale, dataMin, dataMax, deviceMin, deviceMax);
+}
+
+void fxPlotTransform::SetYAxis(fxAxisScale scale, double dataMin, double dataMax, double deviceMin, double deviceMax)
+{
+    m_y = MakeAxis(scale, dataMin, dataMax, deviceMin, deviceMax);
+}
+
+void fxPlotTransform::SetPolar(fxAxisScale radialScale, double rMin)
+{
+    m_polar = true;
+    m_radialLog = radialScale == fxAxisScale::Log10;
+    m_radialOrigin = m_radialLog ? Log10OrNaN(rMin) : rMin;
+}
+
+//--------------------------------------
+// Kernels
+//--------------------------------------
+void fxPlotTransform::MapPoint(double u, double v, double& x, double& y) const
+{
+    if (m_polar) {
+        const double rho = (m_radialLog ? Log10OrNaN(u) : u) - m_radialOrigin;
+        if (!(rho >= 0.0)) {
+            x = y = NaN;
+            return;
+        }
+        x = m_x.a * (rho * std::cos(v)) + m_x.b;
+        y = m_y.a * (rho * std::sin(v)) + m_y.b;
+    } else {
+        x = m_x.a * (m_x.log ? Log10OrNaN(u) : u) + m_x.b;
+        y = m_y.a * (m_y.log ? Log10OrNaN(v) : v) + m_y.b;
+    }
+    if (std::isnan(x) || std::isnan(y)) x = y = NaN;
+}
+
+void fxPlotTransform::MapBlock(const double* u, const double* v, size_t n, double* x, double* y) const
+{
+    size_t i = 0;
+#if FX_SIMD_AVX2
+    if (fxHasAVX2()) {
+        const VectorMapping mapping{m_x.a, m_x.b, m_y.a, m_y.b, m_x.log, m_y.log,
+                                    m_polar, m_radialLog, m_radialOrigin};
+        i = MapBlockAVX2(mapping, u, v, n, x, y, [&](size_t k) { MapPoint(u[k], v[k], x[k], y[k]); });
+    }
+#endif
+    for (; i < n; ++i) MapPoint(u[i], v[i], x[i], y[i]);
+}
+
+void fxPlotTransform::Map(const double* x, const double* y, size_t n, wxPoint2DDouble* out) const
+{
+    double px[CHUNK], py[CHUNK];
+    for (size_t start = 0; start < n; start += CHUNK) {
+        const size_t count = std::min(CHUNK, n - start);
+        MapBlock(x + start, y + start, count, px, py);
+        for (size_t i = 0; i < count; ++i) out[start + i] = wxPoint2DDouble(px[i], py[i]);
+    }
+}
+
+void fxPlotTransform::Map(const double* x, const double* y, size_t n, float* out) const
+{
+    double px[CHUNK], py[CHUNK];
+    for (size_t start = 0; start < n; start += CHUNK) {
+        const size_t count = std::min(CHUNK, n - start);
+        MapBlock(x + start, y + start, count, px, py);
+        float* o = out + 2 * start;
+        for (size_t i = 0; i < count; ++i) {
+            o[2 * i] = float(px[i]);
+            o[2 * i + 1] = float(py[i]);
+        }
+    }
+}
+
+void fxPlotTransform::AppendPolyline(const double* x, const double* y, size_t n, fxGraphicsPath& path) const
+{
+    if (n == 0) return;
+    FX_TRACE_SCOPE(Path, "PlotTransform");
+
+    // Current run: its first point, then the rest as one Polyline segment
+    wxPoint2DDouble runStart;
+    bool inRun = false;
+    std::vector<wxPoint2DDouble> run;
+    auto endRun = [&]() {
+        if (!inRun) return;
+        path.MoveToPoint(runStart);
+        path.AddPolyline(std::move(run));
+        run = std::vector<wxPoint2DDouble>();
+        inRun = false;
+    };
+    auto keep = [&](double px, double py) {
+        if (inRun) {
+            run.emplace_back(px, py);
+        } else {
+            runStart = wxPoint2DDouble(px, py);
+            run.reserve(std::min(n, CHUNK));
+            inRun = true;
+        }
+    };
+
+    // A point is decided once the segment after it is known
+    double lastX = 0.0, lastY = 0.0;
+    bool lastValid = false, lastCrossed = false;   // lastCrossed: the segment before it is visible
+    bool first = true;
+    auto decide = [&](bool visible) {
+        if (lastValid && (!m_hasClip || lastCrossed || visible)) keep(lastX, lastY);
+        else endRun();
+    };
+
+    double px[CHUNK], py[CHUNK];
+    for (size_t start = 0; start < n; start += CHUNK) {
+        const size_t count = std::min(CHUNK, n - start);
+        MapBlock(x + start, y + start, count, px, py);
+
+        for (size_t i = 0; i < count; ++i) {
+            const bool valid = !std::isnan(px[i]);
+            const bool crossed = lastValid && valid &&
+                                 (!m_hasClip || SegmentMayCross(lastX, lastY, px[i], py[i], m_clip));
+            if (!first) decide(crossed);
+            first = false;
+
+            lastX = px[i];
+            lastY = py[i];
+            lastValid = valid;
+            lastCrossed = crossed;
+        }
+    }
+    decide(false);
+    endRun();
+}
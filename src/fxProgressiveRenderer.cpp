@@ -0,0 +1,117 @@
+// fxProgressiveRenderer.cpp
+#include "fxProgressiveRenderer.hpp"
+#include "fxTrace.hpp"
+#include <wx/stopwatch.h>
+
+namespace {
+// Command cost (see fxDrawCommand::cost) drawn between two clock checks
+const size_t COST_PER_CLOCK_CHECK = 2048;
+}
+
+fxProgressiveRenderer::fxProgressiveRenderer()
+    : m_passes(DefaultPasses())
+{
+}
+
+fxProgressiveRenderer::~fxProgressiveRenderer() = default;
+
+std::vector<fxRenderQuality> fxProgressiveRenderer::DefaultPasses()
+{
+    // Draft: no AA, coarse curves, heavy decimation, text as bars
+    fxRenderQuality draft;
+    draft.antialias           = wxANTIALIAS_NONE;
+    draft.flatteningTolerance = 2.0;
+    draft.decimationTolerance = 3.0;
+    draft.placeholderText     = true;
+
+    // Medium: AA back on, sub-pixel decimation, real text
+    fxRenderQuality medium;
+    medium.flatteningTolerance = 0.5;
+    medium.decimationTolerance = 0.5;
+
+    // Full quality
+    fxRenderQuality full;
+
+    return {draft, medium, full};
+}
+
+void fxProgressiveRenderer::Restart(const wxSize& size)
+{
+    m_size = size;
+    m_pass = 0;
+    m_next = 0;
+    m_target.reset();
+    m_presentedPass = -1;
+}
+
+//--------------------------------------
+// Work for a time slice
+//--------------------------------------
+bool fxProgressiveRenderer::Step(long budgetMs)
+{
+    if (!m_list || IsComplete() || m_size.GetWidth() <= 0 || m_size.GetHeight() <= 0) {
+        return false;
+    }
+
+    if (!m_target) BeginPass();
+    FX_TRACE_SCOPE(Frame, "ProgressiveStep");
+
+    wxStopWatch clock;
+    const auto& commands = m_list->GetCommands();
+    size_t costSinceCheck = 0;
+
+    while (m_next < commands.size())
+    {
+        costSinceCheck += commands[m_next].cost;
+        m_list->Replay(*m_target->ctx, m_next, m_next + 1);
+        ++m_next;
+
+        if (costSinceCheck >= COST_PER_CLOCK_CHECK) {
+            costSinceCheck = 0;
+            if (clock.Time() >= budgetMs && m_next < commands.size()) {
+                return false;  // resume on next step
+            }
+        }
+    }
+
+    EndPass();
+    return true;
+}
+
+void fxProgressiveRenderer::BeginPass()
+{
+    m_target = std::make_unique<PassTarget>();
+    m_target->bitmap = wxBitmap(m_size.GetWidth(), m_size.GetHeight());
+    m_target->dc = std::make_unique<wxMemoryDC>(m_target->bitmap);
+    m_target->dc->SetBackground(wxBrush(m_background));
+    m_target->dc->Clear();
+
+    m_target->ctx = std::make_unique<fxDrawingContext>(m_target->dc.get());
+    m_target->ctx->SetRenderQuality(m_passes[m_pass]);
+    m_next = 0;
+}
+
+void fxProgressiveRenderer::EndPass()
+{
+    FX_TRACE_SCOPE(Encode, "EndPass");
+
+    // Release the GC, then the DC, before using the bitmap
+    m_target->ctx.reset();
+    m_target->dc->SelectObject(wxNullBitmap);
+
+    m_presented     = m_target->bitmap;
+    m_presentedPass = static_cast<int>(m_pass);
+
+    m_target.reset();
+    ++m_pass;
+    m_next = 0;
+}
+
+//--------------------------------------
+// Present the best finished frame
+//--------------------------------------
+void fxProgressiveRenderer::Present(fxDrawingContext& ctx)
+{
+    if (!m_presented.IsOk()) return;
+    ctx.DrawBitmap(m_presented, 0, 0, m_presented.GetWidth(), m_presented.GetHeight());
+}
@@ -0,0 +1,77 @@
+// fxProgressiveRenderer.hpp
+
+#ifndef FXPROGRESSIVERENDERER_HPP
+#define FXPROGRESSIVERENDERER_HPP
+
+#include <memory>
+#include <vector>
+#include <wx/bitmap.h>
+#include <wx/dcmemory.h>
+#include "fxDrawingContext.hpp"
+#include "fxDisplayList.hpp"
+
+// Progressive rendering of a recorded drawing.
+// The display list is rendered off-screen in successive passes of increasing
+// quality (by default: draft, medium, full). Each call to Step() works for at
+// most the given time budget, resuming where the previous call stopped, and
+// reports when a pass completed; Present() draws the best finished frame.
+//
+// Typical use: Restart() when the drawing changes, then Step() + Present()
+// from a timer or idle handler until IsComplete().
+class fxProgressiveRenderer
+{
+public:
+    fxProgressiveRenderer();
+    ~fxProgressiveRenderer();
+
+    // Drawing to render (not owned: must stay alive while rendering)
+    void SetDisplayList(const fxDisplayList* list) { m_list = list; m_pass = 0; m_next = 0; m_target.reset(); }
+
+    // Quality of each pass, coarsest first
+    void SetPasses(const std::vector<fxRenderQuality>& passes) { m_passes = passes; }
+    const std::vector<fxRenderQuality>& GetPasses() const { return m_passes; }
+    static std::vector<fxRenderQuality> DefaultPasses();
+
+    void SetBackground(const wxColour& colour) { m_background = colour; }
+
+    // Start over at the given frame size (keeps the last frame for Present)
+    void Restart(const wxSize& size);
+
+    // Render for at most budgetMs milliseconds.
+    // Returns true if a pass was completed, i.e. a better frame is available.
+    bool Step(long budgetMs);
+
+    bool IsComplete() const { return m_pass >= m_passes.size(); }
+
+    // Index of the pass shown by Present(), -1 if none completed yet
+    int GetPresentedPass() const { return m_presentedPass; }
+
+    // Draw the best completed frame
+    void Present(fxDrawingContext& ctx);
+
+private:
+    // Off-screen target of the pass in progress
+    struct PassTarget
+    {
+        wxBitmap bitmap;
+        std::unique_ptr<wxMemoryDC> dc;
+        std::unique_ptr<fxDrawingContext> ctx;
+    };
+
+    const fxDisplayList* m_list = nullptr;
+    std::vector<fxRenderQuality> m_passes;
+    wxColour m_background = *wxWHITE;
+    wxSize   m_size;
+
+    size_t m_pass = 0;     // pass in progress
+    size_t m_next = 0;     // next command of that pass
+    std::unique_ptr<PassTarget> m_target;
+
+    wxBitmap m_presented;
+    int      m_presentedPass = -1;
+
+    void BeginPass();
+    void EndPass();
+};
+
+#endif // FXPROGRESSIVERENDERER_HPP
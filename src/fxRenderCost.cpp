@@ -0,0 +1,209 @@
+// fxRenderCost.cpp
+#include "fxRenderCost.hpp"
+#include <wx/stopwatch.h>
+#include <wx/dcmemory.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+fxRenderBackend GetRenderBackend(const fxDrawingContext& ctx)
+{
+    if (ctx.IsGC()) return fxRenderBackend::GraphicsContext;
+    return ctx.IsRasterTarget() ? fxRenderBackend::RasterDC : fxRenderBackend::VectorDC;
+}
+
+fxRenderCostModel::fxRenderCostModel()
+{
+    // Plain DCs: aliased, cheap vertices
+    auto& dc = m_coeffs[static_cast<size_t>(fxRenderBackend::RasterDC)];
+    dc.perVertex    = 0.02;
+    dc.perFillPixel = 0.0005;
+    dc.perText      = 3.0;
+
+    // Vector output: every vertex is formatted, bitmaps are encoded, no pixels filled
+    auto& vec = m_coeffs[static_cast<size_t>(fxRenderBackend::VectorDC)];
+    vec.perVertex      = 0.2;
+    vec.perFillPixel   = 0.0;
+    vec.perText        = 2.0;
+    vec.perGlyph       = 0.1;
+    vec.perBitmapPixel = 0.05;
+}
+
+void fxRenderCostModel::SetCoefficients(fxRenderBackend backend, const fxRenderCostCoefficients& coeffs)
+{
+    m_coeffs[static_cast<size_t>(backend)] = coeffs;
+}
+
+const fxRenderCostCoefficients& fxRenderCostModel::GetCoefficients(fxRenderBackend backend) const
+{
+    return m_coeffs[static_cast<size_t>(backend)];
+}
+
+//--------------------------------------
+// Estimate
+//--------------------------------------
+fxRenderCostEstimate fxRenderCostModel::Estimate(const fxDisplayList& list, fxRenderBackend backend,
+                                                 double flatteningTolerance) const
+{
+    fxRenderCostEstimate est;
+    const auto& paths = list.GetPaths();
+    const auto& texts = list.GetTexts();
+
+    auto boxArea = [](const wxRect2DDouble& r) { return std::abs(r.m_width * r.m_height); };
+
+    for (const auto& cmd : list.GetCommands())
+    {
+        switch (cmd.type)
+        {
+        case fxDrawCommandType::SetPen:
+        case fxDrawCommandType::SetBrush:
+        case fxDrawCommandType::SetFont:
+        case fxDrawCommandType::SetAntialiasMode:
+        case fxDrawCommandType::Scale:
+            ++est.stateChanges;
+            break;
+
+        case fxDrawCommandType::DrawRectangle:
+            ++est.calls;
+            est.vertices += 4;
+            est.fillArea += std::abs(cmd.points[1].m_x * cmd.points[1].m_y);
+            break;
+
+        case fxDrawCommandType::DrawText:
+        case fxDrawCommandType::DrawRotatedText:
+            ++est.calls;
+            ++est.texts;
+            est.glyphs += texts[cmd.resource].length();
+            break;
+
+        case fxDrawCommandType::StrokeLine:
+        case fxDrawCommandType::StrokeLineSegments:
+        case fxDrawCommandType::StrokeLines:
+            ++est.calls;
+            est.vertices += cmd.points.size();
+            break;
+
+        case fxDrawCommandType::DrawPath:
+        case fxDrawCommandType::FillPath:
+        case fxDrawCommandType::StrokePath:
+            {
+                const auto& path = paths[cmd.resource];
+                ++est.calls;
+                est.vertices += flatteningTolerance > 0.0 ? CountFlattenedVertices(path, flatteningTolerance)
+                                                          : cmd.cost;
+                if (cmd.type != fxDrawCommandType::StrokePath) {
+                    est.fillArea += boxArea(path.GetBox());
+                }
+            }
+            break;
+
+        case fxDrawCommandType::DrawBitmap:
+            ++est.calls;
+            est.bitmapPixels += std::abs(cmd.points[1].m_x * cmd.points[1].m_y);
+            break;
+        }
+    }
+
+    const auto& c = GetCoefficients(backend);
+    const double us = est.calls        * c.perCall
+                    + est.vertices     * c.perVertex
+                    + est.fillArea     * c.perFillPixel
+                    + est.texts        * c.perText
+                    + est.glyphs       * c.perGlyph
+                    + est.stateChanges * c.perStateChange
+                    + est.bitmapPixels * c.perBitmapPixel;
+    est.predictedMs = us / 1000.0;
+    return est;
+}
+
+fxRenderCostEstimate fxRenderCostModel::Estimate(const fxDisplayList& list, const fxDrawingContext& ctx) const
+{
+    return Estimate(list, GetRenderBackend(ctx), ctx.GetRenderQuality().flatteningTolerance);
+}
+
+//--------------------------------------
+// Calibration
+//--------------------------------------
+namespace {
+
+// Microseconds spent on work, including the flush
+double TimeWork(fxDrawingContext& ctx, const std::function<void()>& work)
+{
+    wxStopWatch clock;
+    work();
+    ctx.Flush();
+    return static_cast<double>(clock.TimeInMicro().GetValue());
+}
+
+} // namespace
+
+void fxRenderCostModel::Calibrate(fxDrawingContext& ctx)
+{
+    if (!ctx.IsValid()) return;
+
+    fxRenderCostCoefficients c;
+    const wxPen penA(*wxBLACK, 1), penB(*wxBLUE, 1);
+
+    ctx.SetPen(penA);
+    ctx.SetBrush(*wxLIGHT_GREY_BRUSH);
+
+    // Calls: tiny lines, vertex cost negligible
+    const int NCALLS = 2000;
+    const double callUs = TimeWork(ctx, [&]{
+        for (int i = 0; i < NCALLS; ++i) ctx.StrokeLine(i % 100, 0, i % 100 + 1, 1);
+    }) / NCALLS;
+
+    // Vertices: one long zig-zag polyline
+    const int NVERTS = 20000, NREPS = 5;
+    fxGraphicsPath zigzag = ctx.CreatePath();
+    zigzag.MoveToPoint(0, 0);
+    for (int i = 1; i < NVERTS; ++i) zigzag.AddLineToPoint(i % 200, (i % 2) * 50);
+    const double pathUs = TimeWork(ctx, [&]{
+        for (int r = 0; r < NREPS; ++r) ctx.StrokePath(zigzag);
+    }) / NREPS;
+    c.perVertex = std::max(0.0, (pathUs - callUs) / NVERTS);
+    c.perCall   = std::max(0.0, callUs - 2 * c.perVertex);
+
+    // Fill: large rectangles
+    const int NFILLS = 50;
+    const double side = 200.0;
+    const double fillUs = TimeWork(ctx, [&]{
+        for (int i = 0; i < NFILLS; ++i) ctx.DrawRectangle(0, 0, side, side);
+    }) / NFILLS;
+    c.perFillPixel = std::max(0.0, (fillUs - c.perCall - 4 * c.perVertex) / (side * side));
+
+    // Text: fixed cost from short strings, glyph cost from long ones
+    ctx.SetFont(*wxNORMAL_FONT, *wxBLACK);
+    const int NTEXTS = 300;
+    const wxString longText('x', 64);
+    const double shortUs = TimeWork(ctx, [&]{
+        for (int i = 0; i < NTEXTS; ++i) ctx.DrawText("x", i % 100, 10);
+    }) / NTEXTS;
+    const double longUs = TimeWork(ctx, [&]{
+        for (int i = 0; i < NTEXTS; ++i) ctx.DrawText(longText, i % 100, 10);
+    }) / NTEXTS;
+    c.perGlyph = std::max(0.0, (longUs - shortUs) / (longText.length() - 1));
+    c.perText  = std::max(0.0, shortUs - c.perGlyph - c.perCall);
+
+    // State changes: alternate two pens
+    const int NSTATES = 2000;
+    c.perStateChange = TimeWork(ctx, [&]{
+        for (int i = 0; i < NSTATES; ++i) ctx.SetPen(i % 2 ? penA : penB);
+    }) / NSTATES;
+
+    // Bitmaps
+    const int NBITMAPS = 20, BSIDE = 256;
+    wxBitmap bitmap(BSIDE, BSIDE);
+    {
+        wxMemoryDC memDC(bitmap);
+        memDC.SetBackground(*wxWHITE_BRUSH);
+        memDC.Clear();
+        memDC.SelectObject(wxNullBitmap);
+    }
+    const double bitmapUs = TimeWork(ctx, [&]{
+        for (int i = 0; i < NBITMAPS; ++i) ctx.DrawBitmap(bitmap, 0, 0, BSIDE, BSIDE);
+    }) / NBITMAPS;
+    c.perBitmapPixel = std::max(0.0, (bitmapUs - c.perCall) / (BSIDE * BSIDE));
+
+    SetCoefficients(GetRenderBackend(ctx), c);
+}
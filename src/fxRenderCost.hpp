@@ -0,0 +1,73 @@
+// fxRenderCost.hpp
+
+#ifndef FXRENDERCOST_HPP
+#define FXRENDERCOST_HPP
+
+#include <array>
+#include "fxDrawingContext.hpp"
+#include "fxDisplayList.hpp"
+
+// Backend families with distinct cost profiles
+enum class fxRenderBackend
+{
+    GraphicsContext = 0,  // wxGraphicsContext (antialiased raster)
+    RasterDC,             // plain wxDC on pixels
+    VectorDC,             // wxSVGFileDC, printers: output size dominates
+    Count
+};
+
+// Backend family of a drawing context
+fxRenderBackend GetRenderBackend(const fxDrawingContext& ctx);
+
+// Workload of a recorded drawing, and its predicted duration
+struct fxRenderCostEstimate
+{
+    size_t calls        = 0;    // drawing calls
+    size_t vertices     = 0;    // after flattening
+    double fillArea     = 0.0;  // filled pixels (bounding boxes)
+    size_t texts        = 0;
+    size_t glyphs       = 0;
+    size_t stateChanges = 0;    // pen, brush, font, AA, scale
+    double bitmapPixels = 0.0;  // destination pixels of bitmaps
+    double predictedMs  = 0.0;
+};
+
+// Linear cost coefficients of one backend, in microseconds
+struct fxRenderCostCoefficients
+{
+    double perCall        = 1.0;
+    double perVertex      = 0.05;
+    double perFillPixel   = 0.001;
+    double perText        = 5.0;
+    double perGlyph       = 0.5;
+    double perStateChange = 0.5;
+    double perBitmapPixel = 0.002;
+};
+
+// Predicts the rendering time of display lists from their workload.
+// Default coefficients are rough; Calibrate() measures them on a context.
+class fxRenderCostModel
+{
+public:
+    fxRenderCostModel();
+
+    void SetCoefficients(fxRenderBackend backend, const fxRenderCostCoefficients& coeffs);
+    const fxRenderCostCoefficients& GetCoefficients(fxRenderBackend backend) const;
+
+    // Workload and predicted time of a display list on a backend.
+    // Curves are counted as flattened within tolerance (0 = fixed steps).
+    fxRenderCostEstimate Estimate(const fxDisplayList& list, fxRenderBackend backend,
+                                  double flatteningTolerance = 0.0) const;
+
+    // Estimate for the backend and quality of ctx
+    fxRenderCostEstimate Estimate(const fxDisplayList& list, const fxDrawingContext& ctx) const;
+
+    // Time synthetic workloads on ctx and fit the coefficients of its backend.
+    // This draws on ctx: use an off-screen target. Takes some 100 ms.
+    void Calibrate(fxDrawingContext& ctx);
+
+private:
+    std::array<fxRenderCostCoefficients, static_cast<size_t>(fxRenderBackend::Count)> m_coeffs;
+};
+
+#endif // FXRENDERCOST_HPP
@@ -0,0 +1,113 @@
+// fxRenderStats.hpp
+
+#ifndef FXRENDERSTATS_HPP
+#define FXRENDERSTATS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+// Render statistics are collected only when FX_RENDER_STATS is defined
+// (e.g. -DFX_RENDER_STATS). Otherwise the FX_STATS_* macros expand to
+// nothing and fxDrawingContext has neither the counters nor GetStats().
+
+// Instrumented fxDrawingContext calls
+enum class fxRenderCallKind
+{
+    SetPen = 0,
+    SetBrush,
+    SetFont,
+    TextExtent,
+    DrawRectangle,
+    DrawText,
+    StrokeLine,
+    StrokeLines,
+    CreatePath,
+    DrawPath,
+    FillPath,
+    StrokePath,
+    DrawBitmap,
+    Flush,
+    Count
+};
+
+struct fxRenderStats
+{
+    static constexpr size_t KINDS = static_cast<size_t>(fxRenderCallKind::Count);
+
+    std::array<size_t, KINDS> calls{};    // number of calls by kind
+    std::array<double, KINDS> timeUs{};   // time spent in the backend by kind
+    size_t vertices       = 0;            // emitted after flattening
+    size_t stateChanges   = 0;            // pen/brush/font actually changed
+    size_t nativeObjects  = 0;            // native paths, scaled bitmaps... created
+    size_t bytesAllocated = 0;            // temporary buffers (estimate)
+
+    size_t GetCalls(fxRenderCallKind kind) const { return calls[static_cast<size_t>(kind)]; }
+    double GetTime(fxRenderCallKind kind) const { return timeUs[static_cast<size_t>(kind)]; }
+
+    size_t GetTotalCalls() const
+    {
+        size_t n = 0;
+        for (auto c : calls) n += c;
+        return n;
+    }
+
+    double GetTotalTime() const
+    {
+        double t = 0.0;
+        for (auto v : timeUs) t += v;
+        return t;
+    }
+
+    void Reset() { *this = fxRenderStats(); }
+
+    static const char* GetKindName(fxRenderCallKind kind)
+    {
+        static const char* const names[KINDS] = {
+            "SetPen", "SetBrush", "SetFont", "TextExtent", "DrawRectangle", "DrawText",
+            "StrokeLine", "StrokeLines", "CreatePath", "DrawPath", "FillPath", "StrokePath",
+            "DrawBitmap", "Flush"
+        };
+        return names[static_cast<size_t>(kind)];
+    }
+};
+
+#ifdef FX_RENDER_STATS
+
+// Counts one call and adds its duration on scope exit
+class fxRenderStatsScope
+{
+public:
+    fxRenderStatsScope(fxRenderStats& stats, fxRenderCallKind kind)
+        : m_stats(stats), m_kind(static_cast<size_t>(kind)), m_start(std::chrono::steady_clock::now())
+    {
+        ++m_stats.calls[m_kind];
+    }
+
+    ~fxRenderStatsScope()
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - m_start;
+        m_stats.timeUs[m_kind] += std::chrono::duration<double, std::micro>(elapsed).count();
+    }
+
+private:
+    fxRenderStats& m_stats;
+    size_t m_kind;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+#define FX_STATS_SCOPE(stats, kind)   fxRenderStatsScope fxStatsScope_(stats, fxRenderCallKind::kind)
+#define FX_STATS_ADD(stats, field, n) ((stats).field += (n))
+#define FX_STATS_IF(code)             code
+#define FX_STATS_LOG(...)             wxLogDebug(__VA_ARGS__)
+
+#else
+
+#define FX_STATS_SCOPE(stats, kind)   ((void)0)
+#define FX_STATS_ADD(stats, field, n) ((void)0)
+#define FX_STATS_IF(code)
+#define FX_STATS_LOG(...)             ((void)0)
+
+#endif // FX_RENDER_STATS
+
+#endif // FXRENDERSTATS_HPP
@@ -0,0 +1,212 @@
+// fxSampleQueue.hpp
+
+#ifndef FXSAMPLEQUEUE_HPP
+#define FXSAMPLEQUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "fxStreamingPath.hpp"
+
+// Bounded lock-free queues carrying samples from acquisition threads to the
+// thread that draws them.
+//
+// Both queues are made for bulk numeric data: producers push arrays, and the
+// consumer takes whatever is ready in at most two contiguous runs, handed to
+// a callback that appends them where they go (a path, a decimator) without an
+// intermediate copy. Push never blocks: it returns how many items fitted and
+// the producer decides what to do with the rest. The capacity is rounded up
+// to a power of two.
+
+//--------------------------------------
+// Single producer, single consumer
+//--------------------------------------
+template <typename T>
+class fxSpscQueue
+{
+    static_assert(std::is_trivially_copyable<T>::value, "fxSpscQueue holds trivially copyable samples");
+
+public:
+    explicit fxSpscQueue(size_t capacity)
+        : m_buffer(RoundUp(capacity)), m_mask(m_buffer.size() - 1)
+    {
+    }
+
+    size_t GetCapacity() const { return m_buffer.size(); }
+
+    // Producer side: returns the number of items queued
+    size_t Push(const T* items, size_t n)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (m_buffer.size() - (head - m_producerTail) < n) {
+            m_producerTail = m_tail.load(std::memory_order_acquire);
+        }
+        const size_t count = std::min(n, m_buffer.size() - (head - m_producerTail));
+        if (count == 0) return 0;
+
+        const size_t start = head & m_mask;
+        const size_t first = std::min(count, m_buffer.size() - start);
+        std::copy(items, items + first, m_buffer.begin() + start);
+        std::copy(items + first, items + count, m_buffer.begin());
+
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    bool Push(const T& item) { return Push(&item, 1) == 1; }
+
+    // Consumer side: fn(const T* items, size_t n) is called for up to two
+    // contiguous runs holding at most max items; returns the number consumed
+    template <typename F>
+    size_t Consume(F&& fn, size_t max = std::numeric_limits<size_t>::max())
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (m_consumerHead == tail) {
+            m_consumerHead = m_head.load(std::memory_order_acquire);
+        }
+        const size_t count = std::min(max, m_consumerHead - tail);
+        if (count == 0) return 0;
+
+        const size_t start = tail & m_mask;
+        const size_t first = std::min(count, m_buffer.size() - start);
+        fn(&m_buffer[start], first);
+        if (count > first) fn(&m_buffer[0], count - first);
+
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Copy up to max items to out
+    size_t Pop(T* out, size_t max)
+    {
+        return Consume([&out](const T* items, size_t n) { out = std::copy(items, items + n, out); }, max);
+    }
+
+    // Items queued, as seen from the calling thread
+    size_t GetSizeApprox() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    std::vector<T> m_buffer;
+    const size_t   m_mask;
+
+    alignas(64) std::atomic<size_t> m_head{0};      // next write (own cache line)
+    size_t m_producerTail = 0;                      // producer's copy of m_tail
+
+    alignas(64) std::atomic<size_t> m_tail{0};      // next read
+    size_t m_consumerHead = 0;                      // consumer's copy of m_head
+
+    static size_t RoundUp(size_t n)
+    {
+        size_t size = 2;
+        while (size < n) size *= 2;
+        return size;
+    }
+};
+
+//--------------------------------------
+// Multiple producers, single consumer
+//--------------------------------------
+// Producers reserve a run of slots with a compare-and-swap on the write index,
+// fill it, and mark each slot with its position. The consumer takes the ready
+// slots in order and stops at the first one still being filled, so a slow
+// producer delays consumption but never blocks the other producers.
+template <typename T>
+class fxMpscQueue
+{
+    static_assert(std::is_trivially_copyable<T>::value, "fxMpscQueue holds trivially copyable samples");
+
+public:
+    explicit fxMpscQueue(size_t capacity)
+        : m_buffer(RoundUp(capacity)), m_mask(m_buffer.size() - 1),
+          m_ready(new std::atomic<uint64_t>[m_buffer.size()])
+    {
+        for (size_t i = 0; i < m_buffer.size(); ++i) m_ready[i].store(0, std::memory_order_relaxed);
+    }
+
+    size_t GetCapacity() const { return m_buffer.size(); }
+
+    // Producer side, any thread: returns the number of items queued
+    size_t Push(const T* items, size_t n)
+    {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        size_t count;
+        do {
+            const uint64_t tail = m_tail.load(std::memory_order_acquire);
+            count = static_cast<size_t>(std::min<uint64_t>(n, m_buffer.size() - (head - tail)));
+            if (count == 0) return 0;
+        } while (!m_head.compare_exchange_weak(head, head + count, std::memory_order_relaxed));
+
+        for (size_t i = 0; i < count; ++i) {
+            const uint64_t position = head + i;
+            m_buffer[position & m_mask] = items[i];
+            m_ready[position & m_mask].store(position + 1, std::memory_order_release);
+        }
+        return count;
+    }
+
+    bool Push(const T& item) { return Push(&item, 1) == 1; }
+
+    // Consumer side: as fxSpscQueue::Consume
+    template <typename F>
+    size_t Consume(F&& fn, size_t max = std::numeric_limits<size_t>::max())
+    {
+        const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+
+        size_t count = 0;
+        while (count < max && count < m_buffer.size() &&
+               m_ready[(tail + count) & m_mask].load(std::memory_order_acquire) == tail + count + 1) {
+            ++count;
+        }
+        if (count == 0) return 0;
+
+        const size_t start = tail & m_mask;
+        const size_t first = std::min(count, m_buffer.size() - start);
+        fn(&m_buffer[start], first);
+        if (count > first) fn(&m_buffer[0], count - first);
+
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    size_t Pop(T* out, size_t max)
+    {
+        return Consume([&out](const T* items, size_t n) { out = std::copy(items, items + n, out); }, max);
+    }
+
+    size_t GetSizeApprox() const
+    {
+        return static_cast<size_t>(m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire));
+    }
+
+private:
+    std::vector<T> m_buffer;
+    const size_t   m_mask;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_ready;    // position + 1 once written
+
+    alignas(64) std::atomic<uint64_t> m_head{0};    // next reservation
+    alignas(64) std::atomic<uint64_t> m_tail{0};    // next read
+
+    static size_t RoundUp(size_t n)
+    {
+        size_t size = 2;
+        while (size < n) size *= 2;
+        return size;
+    }
+};
+
+// Move queued points into a streaming path (at most max); returns the number moved
+template <typename Queue>
+size_t DrainInto(Queue& queue, fxStreamingPath& path, size_t max = std::numeric_limits<size_t>::max())
+{
+    return queue.Consume([&path](const wxPoint2DDouble* points, size_t n) { path.Append(points, n); }, max);
+}
+
+#endif // FXSAMPLEQUEUE_HPP
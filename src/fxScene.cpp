@@ -0,0 +1,288 @@
+// fxScene.cpp
+#include "fxScene.hpp"
+#include "fxTrace.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// World = local transform followed by the parent transform
+wxAffineMatrix2D ComposeTransforms(const wxAffineMatrix2D& local, const wxAffineMatrix2D& parent)
+{
+    wxMatrix2D l, p;
+    wxPoint2DDouble lt, pt;
+    local.Get(&l, &lt);
+    parent.Get(&p, &pt);
+
+    wxMatrix2D c(l.m_11 * p.m_11 + l.m_12 * p.m_21,
+                 l.m_11 * p.m_12 + l.m_12 * p.m_22,
+                 l.m_21 * p.m_11 + l.m_22 * p.m_21,
+                 l.m_21 * p.m_12 + l.m_22 * p.m_22);
+
+    wxAffineMatrix2D world;
+    world.Set(c, parent.TransformPoint(lt));
+    return world;
+}
+
+// Inclusive overlap test: degenerate boxes (e.g. a horizontal line) still count
+bool Overlaps(const wxRect2DDouble& a, const wxRect2DDouble& b)
+{
+    return a.m_x <= b.m_x + b.m_width  && b.m_x <= a.m_x + a.m_width &&
+           a.m_y <= b.m_y + b.m_height && b.m_y <= a.m_y + a.m_height;
+}
+
+wxRect2DDouble UnionBox(const wxRect2DDouble& a, const wxRect2DDouble& b)
+{
+    const double x0 = std::min(a.m_x, b.m_x);
+    const double y0 = std::min(a.m_y, b.m_y);
+    const double x1 = std::max(a.m_x + a.m_width,  b.m_x + b.m_width);
+    const double y1 = std::max(a.m_y + a.m_height, b.m_y + b.m_height);
+    return wxRect2DDouble(x0, y0, x1 - x0, y1 - y0);
+}
+
+} // namespace
+
+//--------------------------------------
+// Hierarchy
+//--------------------------------------
+fxSceneNode& fxSceneNode::AddChild(const wxString& name)
+{
+    m_children.push_back(std::make_unique<fxSceneNode>(name));
+    fxSceneNode& child = *m_children.back();
+    child.m_parent = this;
+    child.MarkDirty(DIRTY_TRANSFORM | DIRTY_CONTENT);
+    return child;
+}
+
+void fxSceneNode::RemoveChild(fxSceneNode* child)
+{
+    m_children.erase(std::remove_if(m_children.begin(), m_children.end(),
+                                    [&](const std::unique_ptr<fxSceneNode>& c) { return c.get() == child; }),
+                     m_children.end());
+    MarkDirty(DIRTY_CHILDREN);
+}
+
+// Flag this node and tell the ancestors that something below them changed
+void fxSceneNode::MarkDirty(int flags)
+{
+    m_dirty |= flags;
+    for (fxSceneNode* p = m_parent; p && !(p->m_dirty & DIRTY_CHILDREN); p = p->m_parent) {
+        p->m_dirty |= DIRTY_CHILDREN;
+    }
+}
+
+//--------------------------------------
+// Local state
+//--------------------------------------
+void fxSceneNode::SetTransform(const wxAffineMatrix2D& matrix)
+{
+    m_local = matrix;
+    MarkDirty(DIRTY_TRANSFORM);
+}
+
+void fxSceneNode::SetPath(const fxGraphicsPath& path, fxScenePaintMode mode, wxPolygonFillMode fillStyle)
+{
+    m_path      = fxGraphicsPath(nullptr, path);  // keep geometry only
+    m_hasPath   = true;
+    m_paintMode = mode;
+    m_fillStyle = fillStyle;
+    MarkDirty(DIRTY_CONTENT);
+}
+
+void fxSceneNode::SetPen(const wxPen& pen)
+{
+    // Pen width affects the stroked bounds
+    m_pen = pen;
+    MarkDirty(DIRTY_CONTENT);
+}
+
+void fxSceneNode::SetBrush(const wxBrush& brush)
+{
+    // Geometry is unchanged: nothing to recompute
+    m_brush = brush;
+}
+
+void fxSceneNode::SetText(const wxString& text, const wxFont& font, const wxColour& colour, wxDouble angleRad)
+{
+    m_text       = text;
+    m_font       = font;
+    m_textColour = colour;
+    m_textAngle  = angleRad;
+    m_textWidth  = -1.0;  // measure again
+    MarkDirty(DIRTY_CONTENT);
+}
+
+void fxSceneNode::ClearContent()
+{
+    m_path    = fxGraphicsPath();
+    m_hasPath = false;
+    m_text.clear();
+    MarkDirty(DIRTY_CONTENT);
+}
+
+void fxSceneNode::SetVisible(bool visible)
+{
+    if (m_visible == visible) return;
+    m_visible = visible;
+    if (m_parent) m_parent->MarkDirty(DIRTY_CHILDREN);
+}
+
+//--------------------------------------
+// Update: refresh dirty world state
+//--------------------------------------
+void fxSceneNode::Update(fxDrawingContext& ctx, const wxAffineMatrix2D& parentWorld, bool parentChanged)
+{
+    const bool worldChanged = parentChanged || (m_dirty & DIRTY_TRANSFORM);
+
+    // Clean subtree under an unchanged parent: nothing to do
+    if (!worldChanged && m_dirty == DIRTY_NONE) return;
+
+    if (worldChanged) {
+        m_world = ComposeTransforms(m_local, parentWorld);
+    }
+    if (worldChanged || (m_dirty & DIRTY_CONTENT)) {
+        UpdateWorldContent(ctx);
+    }
+
+    m_hasSubtreeBounds = m_hasBounds;
+    m_subtreeBounds    = m_bounds;
+
+    for (auto& child : m_children)
+    {
+        child->Update(ctx, m_world, worldChanged);
+        if (!child->m_visible || !child->m_hasSubtreeBounds) continue;
+
+        m_subtreeBounds = m_hasSubtreeBounds ? UnionBox(m_subtreeBounds, child->m_subtreeBounds)
+                                             : child->m_subtreeBounds;
+        m_hasSubtreeBounds = true;
+    }
+
+    m_dirty = DIRTY_NONE;
+}
+
+void fxSceneNode::UpdateWorldContent(fxDrawingContext& ctx)
+{
+    m_hasBounds = false;
+
+    if (m_hasPath)
+    {
+        m_worldPath = fxGraphicsPath(nullptr, m_path);
+        m_worldPath.Transform(m_world);
+        m_bounds = m_worldPath.GetBox();
+
+        if (m_paintMode != fxScenePaintMode::Fill && m_pen.IsOk()) {
+            const double hw = 0.5 * m_pen.GetWidth();
+            m_bounds = wxRect2DDouble(m_bounds.m_x - hw, m_bounds.m_y - hw,
+                                      m_bounds.m_width + 2 * hw, m_bounds.m_height + 2 * hw);
+        }
+        m_hasBounds = !m_worldPath.GetSegments().empty();
+    }
+
+    if (!m_text.empty())
+    {
+        wxMatrix2D m;
+        wxPoint2DDouble t;
+        m_world.Get(&m, &t);
+
+        m_worldTextPos   = m_world.TransformPoint(wxPoint2DDouble(0, 0));
+        m_worldTextAngle = m_textAngle - std::atan2(m.m_12, m.m_11);
+
+        if (m_textWidth < 0.0) {
+            ctx.SetFont(m_font, m_textColour);
+            ctx.GetTextExtent(m_text, &m_textWidth, &m_textHeight);
+        }
+
+        // Rotated text box (text angles are counterclockwise on screen)
+        const double c = std::cos(m_worldTextAngle), s = std::sin(m_worldTextAngle);
+        const wxPoint2DDouble corners[4] = {
+            {0, 0}, {m_textWidth, 0}, {m_textWidth, m_textHeight}, {0, m_textHeight}
+        };
+        double minx = m_worldTextPos.m_x, maxx = minx;
+        double miny = m_worldTextPos.m_y, maxy = miny;
+        for (const auto& p : corners) {
+            const double x = m_worldTextPos.m_x + p.m_x * c + p.m_y * s;
+            const double y = m_worldTextPos.m_y - p.m_x * s + p.m_y * c;
+            minx = std::min(minx, x); maxx = std::max(maxx, x);
+            miny = std::min(miny, y); maxy = std::max(maxy, y);
+        }
+        const wxRect2DDouble textBox(minx, miny, maxx - minx, maxy - miny);
+        m_bounds    = m_hasBounds ? UnionBox(m_bounds, textBox) : textBox;
+        m_hasBounds = true;
+    }
+}
+
+//--------------------------------------
+// Render with culling
+//--------------------------------------
+void fxSceneNode::Render(fxDrawingContext& ctx, const wxRect2DDouble& view, size_t& drawn)
+{
+    if (!m_visible || !m_hasSubtreeBounds || !Overlaps(m_subtreeBounds, view)) return;
+
+    if (m_hasBounds && Overlaps(m_bounds, view)) {
+        DrawContent(ctx);
+        ++drawn;
+    }
+
+    for (auto& child : m_children) {
+        child->Render(ctx, view, drawn);
+    }
+}
+
+void fxSceneNode::DrawContent(fxDrawingContext& ctx)
+{
+    if (m_hasPath)
+    {
+        // Keep the native path of the last GC we drew on, so that static
+        // nodes don't rebuild it every frame
+        if (ctx.IsGC() && !ctx.IsRecording()) {
+            wxGraphicsContext* gc = std::get<wxGraphicsContext*>(ctx.GetVariant());
+            if (m_worldPath.GetContext() != gc) {
+                m_worldPath = fxGraphicsPath(gc, m_worldPath);
+            }
+        }
+
+        if (m_paintMode != fxScenePaintMode::Stroke) {
+            ctx.SetBrush(m_brush);
+            ctx.FillPath(m_worldPath, m_fillStyle);
+        }
+        if (m_paintMode != fxScenePaintMode::Fill) {
+            ctx.SetPen(m_pen);
+            ctx.StrokePath(m_worldPath);
+        }
+    }
+
+    if (!m_text.empty())
+    {
+        ctx.SetFont(m_font, m_textColour);
+        if (m_worldTextAngle == 0.0) {
+            ctx.DrawText(m_text, m_worldTextPos.m_x, m_worldTextPos.m_y);
+        } else {
+            ctx.DrawText(m_text, m_worldTextPos.m_x, m_worldTextPos.m_y, m_worldTextAngle);
+        }
+    }
+}
+
+//--------------------------------------
+// fxScene
+//--------------------------------------
+void fxScene::Update(fxDrawingContext& ctx)
+{
+    m_root.Update(ctx, wxAffineMatrix2D(), false);
+}
+
+size_t fxScene::Render(fxDrawingContext& ctx, const wxRect2DDouble& view)
+{
+    FX_TRACE_SCOPE(Layer, "Scene::Render");
+    Update(ctx);
+
+    size_t drawn = 0;
+    m_root.Render(ctx, view, drawn);
+    return drawn;
+}
+
+size_t fxScene::Render(fxDrawingContext& ctx)
+{
+    wxDouble w = 0.0, h = 0.0;
+    ctx.GetSize(&w, &h);
+    return Render(ctx, wxRect2DDouble(0, 0, w, h));
+}
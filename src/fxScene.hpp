@@ -0,0 +1,140 @@
+// fxScene.hpp
+
+#ifndef FXSCENE_HPP
+#define FXSCENE_HPP
+
+#include <memory>
+#include <vector>
+#include <wx/affinematrix2d.h>
+#include "fxDrawingContext.hpp"
+#include "fxGraphicsPath.hpp"
+
+// How a node's path is rendered
+enum class fxScenePaintMode {
+    Fill,
+    Stroke,
+    FillAndStroke
+};
+
+// A node of the retained scene.
+// Each node has a local transform, an optional path (in local coordinates)
+// and/or an optional text label anchored at the local origin. World
+// transforms, world-space geometry and bounding boxes are cached and only
+// recomputed for nodes flagged dirty.
+class fxSceneNode
+{
+public:
+    explicit fxSceneNode(const wxString& name = wxString()) : m_name(name) {}
+
+    fxSceneNode(const fxSceneNode&) = delete;
+    fxSceneNode& operator=(const fxSceneNode&) = delete;
+
+    //================================================
+    // Hierarchy
+    //================================================
+    fxSceneNode& AddChild(const wxString& name = wxString());
+    void RemoveChild(fxSceneNode* child);
+    fxSceneNode* GetParent() const { return m_parent; }
+    const std::vector<std::unique_ptr<fxSceneNode>>& GetChildren() const { return m_children; }
+    const wxString& GetName() const { return m_name; }
+
+    //================================================
+    // Transform
+    //================================================
+    void SetTransform(const wxAffineMatrix2D& matrix);
+    const wxAffineMatrix2D& GetTransform() const { return m_local; }
+    const wxAffineMatrix2D& GetWorldTransform() const { return m_world; }
+
+    //================================================
+    // Content
+    //================================================
+    // Only the segments of the path are kept (any native path is dropped)
+    void SetPath(const fxGraphicsPath& path, fxScenePaintMode mode = fxScenePaintMode::FillAndStroke,
+                 wxPolygonFillMode fillStyle = wxODDEVEN_RULE);
+    void SetPen(const wxPen& pen);
+    void SetBrush(const wxBrush& brush);
+    void SetText(const wxString& text, const wxFont& font, const wxColour& colour = *wxBLACK,
+                 wxDouble angleRad = 0.0);
+    void ClearContent();
+
+    void SetVisible(bool visible);
+    bool IsVisible() const { return m_visible; }
+
+    //================================================
+    // Bounds (world space, valid after fxScene::Update)
+    //================================================
+    const wxRect2DDouble& GetBounds() const { return m_bounds; }         // own content
+    const wxRect2DDouble& GetSubtreeBounds() const { return m_subtreeBounds; }
+    bool HasBounds() const { return m_hasSubtreeBounds; }
+
+private:
+    friend class fxScene;
+
+    enum DirtyFlags {
+        DIRTY_NONE      = 0,
+        DIRTY_TRANSFORM = 1 << 0,   // local transform changed
+        DIRTY_CONTENT   = 1 << 1,   // path, pen or text changed
+        DIRTY_CHILDREN  = 1 << 2    // some descendant is dirty
+    };
+
+    wxString     m_name;
+    fxSceneNode* m_parent = nullptr;
+    std::vector<std::unique_ptr<fxSceneNode>> m_children;
+    bool         m_visible = true;
+    int          m_dirty = DIRTY_TRANSFORM | DIRTY_CONTENT;
+
+    // Local state
+    wxAffineMatrix2D  m_local;
+    fxGraphicsPath    m_path;
+    bool              m_hasPath = false;
+    fxScenePaintMode  m_paintMode = fxScenePaintMode::FillAndStroke;
+    wxPolygonFillMode m_fillStyle = wxODDEVEN_RULE;
+    wxPen             m_pen = *wxBLACK_PEN;
+    wxBrush           m_brush = *wxTRANSPARENT_BRUSH;
+    wxString          m_text;
+    wxFont            m_font;
+    wxColour          m_textColour = *wxBLACK;
+    wxDouble          m_textAngle = 0.0;
+
+    // Cached world state
+    wxAffineMatrix2D  m_world;
+    fxGraphicsPath    m_worldPath;     // rebound to the last GC it was drawn on
+    wxPoint2DDouble   m_worldTextPos;
+    wxDouble          m_worldTextAngle = 0.0;
+    wxDouble          m_textWidth = -1.0, m_textHeight = 0.0;  // measured lazily
+    wxRect2DDouble    m_bounds;
+    wxRect2DDouble    m_subtreeBounds;
+    bool              m_hasBounds = false;
+    bool              m_hasSubtreeBounds = false;
+
+    void MarkDirty(int flags);
+    void Update(fxDrawingContext& ctx, const wxAffineMatrix2D& parentWorld, bool parentChanged);
+    void UpdateWorldContent(fxDrawingContext& ctx);
+    void Render(fxDrawingContext& ctx, const wxRect2DDouble& view, size_t& drawn);
+    void DrawContent(fxDrawingContext& ctx);
+};
+
+// Retained-mode scene: a tree of fxSceneNode drawn through fxDrawingContext
+// with view-rectangle culling.
+class fxScene
+{
+public:
+    fxScene() : m_root("root") {}
+
+    fxSceneNode& GetRoot() { return m_root; }
+
+    // Refresh dirty transforms and bounds. Text is measured on ctx.
+    void Update(fxDrawingContext& ctx);
+
+    // Update, then draw every visible node intersecting the view rectangle
+    // (device coordinates). Returns the number of nodes drawn.
+    size_t Render(fxDrawingContext& ctx, const wxRect2DDouble& view);
+
+    // Render with the whole context area as view
+    size_t Render(fxDrawingContext& ctx);
+
+private:
+    fxSceneNode m_root;
+};
+
+#endif // FXSCENE_HPP
@@ -0,0 +1,34 @@
+// fxSimd.hpp
+
+#ifndef FXSIMD_HPP
+#define FXSIMD_HPP
+
+// AVX2 kernels without a build flag.
+//
+// The kernels are compiled for AVX2 one function at a time (FX_TARGET_AVX2)
+// while the rest of the program keeps the baseline instruction set, and are
+// only called when fxHasAVX2() reports the CPU supports them. Each caller
+// keeps its scalar loop for the remaining elements and for other CPUs.
+// FX_SIMD_AVX2 is 0 where the compiler can't do this (non-x86 targets).
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define FX_SIMD_AVX2 1
+#define FX_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#else
+#define FX_SIMD_AVX2 0
+#define FX_TARGET_AVX2
+#endif
+
+// True when the AVX2 kernels can run on this CPU
+inline bool fxHasAVX2()
+{
+#if FX_SIMD_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+#else
+    return false;
+#endif
+}
+
+#endif // FXSIMD_HPP
@@ -0,0 +1,230 @@
+// fxStreamingPath.cpp
+#include "fxStreamingPath.hpp"
+#include "fxTrace.hpp"
+#include <wx/dcmemory.h>
+#include <algorithm>
+#include <cmath>
+
+//--------------------------------------
+// fxStreamingPath
+//--------------------------------------
+fxStreamingPath::fxStreamingPath(size_t capacity)
+    : m_ring(std::max<size_t>(1, capacity))
+{
+}
+
+void fxStreamingPath::SetCapacity(size_t capacity)
+{
+    m_ring.assign(std::max<size_t>(1, capacity), wxPoint2DDouble());
+    Clear();
+}
+
+void fxStreamingPath::Clear()
+{
+    // Sequence numbers keep counting, so that renderers notice the change
+    m_first = 0;
+    m_size = 0;
+}
+
+void fxStreamingPath::Append(const wxPoint2DDouble& point)
+{
+    const size_t capacity = m_ring.size();
+    if (m_size < capacity) {
+        m_ring[(m_first + m_size) % capacity] = point;
+        ++m_size;
+    } else {
+        m_ring[m_first] = point;
+        m_first = (m_first + 1) % capacity;
+    }
+    ++m_appended;
+}
+
+void fxStreamingPath::Append(const wxPoint2DDouble* points, size_t n)
+{
+    const size_t capacity = m_ring.size();
+    m_appended += n;
+
+    if (n >= capacity) {
+        std::copy(points + (n - capacity), points + n, m_ring.begin());
+        m_first = 0;
+        m_size = capacity;
+        return;
+    }
+
+    // At most two contiguous runs
+    const size_t write = (m_first + m_size) % capacity;
+    const size_t head = std::min(n, capacity - write);
+    std::copy(points, points + head, m_ring.begin() + write);
+    std::copy(points + head, points + n, m_ring.begin());
+
+    m_size += n;
+    if (m_size > capacity) {
+        m_first = (m_first + m_size - capacity) % capacity;
+        m_size = capacity;
+    }
+}
+
+fxGraphicsPath fxStreamingPath::ToPath() const
+{
+    fxGraphicsPath path;
+    if (m_size == 0) return path;
+
+    path.MoveToPoint(Front());
+    for (size_t i = 1; i < m_size; ++i) path.AddLineToPoint((*this)[i]);
+    return path;
+}
+
+//--------------------------------------
+// fxStreamingPlot
+//--------------------------------------
+fxStreamingPlot::fxStreamingPlot(const fxStreamingPath* path)
+    : m_path(path)
+{
+}
+
+void fxStreamingPlot::SetXSpan(double span)
+{
+    if (span > 0.0 && span != m_xSpan) {
+        m_xSpan = span;
+        Invalidate();
+    }
+}
+
+void fxStreamingPlot::SetYRange(double min, double max)
+{
+    if (min != m_yMin || max != m_yMax) {
+        m_yMin = min;
+        m_yMax = max;
+        Invalidate();
+    }
+}
+
+wxPoint2DDouble fxStreamingPlot::ToDevice(const wxPoint2DDouble& p, const wxSize& size) const
+{
+    const double ySpan = m_yMax - m_yMin;
+    return wxPoint2DDouble(size.GetWidth() - (m_rightX - p.m_x) * size.GetWidth() / m_xSpan,
+                           ySpan != 0.0 ? (m_yMax - p.m_y) * size.GetHeight() / ySpan : 0.0);
+}
+
+uint64_t fxStreamingPlot::FirstVisible() const
+{
+    // Back from the newest sample to the first one left of the window
+    const double left = m_rightX - m_xSpan;
+    const uint64_t first = m_path->GetFirstSequence();
+    uint64_t s = m_path->GetAppendedCount();
+    while (s > first && m_path->AtSequence(s - 1).m_x >= left) --s;
+    return s > first ? s - 1 : first;
+}
+
+void fxStreamingPlot::StrokeFrom(fxDrawingContext& ctx, uint64_t sequence, const wxSize& size)
+{
+    const uint64_t end = m_path->GetAppendedCount();
+    sequence = std::max(sequence, m_path->GetFirstSequence());
+
+    m_points.clear();
+    for (uint64_t s = sequence; s < end; ++s) m_points.push_back(ToDevice(m_path->AtSequence(s), size));
+    if (m_points.size() < 2) return;
+
+    ctx.SetPen(m_pen);
+    ctx.StrokeLines(m_points.size(), m_points.data());
+}
+
+//--------------------------------------
+// Frame handling
+//--------------------------------------
+void fxStreamingPlot::RedrawFrame()
+{
+    if (!m_frame.IsOk() || m_frame.GetSize() != m_size) {
+        m_frame = wxBitmap(m_size.GetWidth(), m_size.GetHeight());
+        m_spare = wxBitmap(m_size.GetWidth(), m_size.GetHeight());
+    }
+
+    wxMemoryDC dc(m_frame);
+    dc.SetBackground(wxBrush(m_background));
+    dc.Clear();
+    if (!m_path->IsEmpty()) {
+        fxDrawingContext frameCtx(&dc);
+        StrokeFrom(frameCtx, FirstVisible(), m_size);
+    }
+    dc.SelectObject(wxNullBitmap);
+}
+
+void fxStreamingPlot::ScrollFrame(int pixels)
+{
+    const int width = m_size.GetWidth(), height = m_size.GetHeight();
+    {
+        wxMemoryDC source;
+        source.SelectObjectAsSource(m_frame);
+        wxMemoryDC target(m_spare);
+
+        target.Blit(0, 0, width - pixels, height, &source, pixels, 0);
+        target.SetPen(*wxTRANSPARENT_PEN);
+        target.SetBrush(wxBrush(m_background));
+        target.DrawRectangle(width - pixels, 0, pixels, height);
+
+        target.SelectObject(wxNullBitmap);
+        source.SelectObject(wxNullBitmap);
+    }
+    std::swap(m_frame, m_spare);
+}
+
+//--------------------------------------
+// Render
+//--------------------------------------
+void fxStreamingPlot::Render(fxDrawingContext& ctx, const wxSize& size)
+{
+    m_incremental = false;
+    if (!m_path || size.GetWidth() <= 0 || size.GetHeight() <= 0) return;
+    FX_TRACE_SCOPE(Path, "StreamingPlot");
+
+    // Vector targets: the whole window, straight to the target
+    if (!ctx.IsRasterTarget()) {
+        ctx.SetPen(*wxTRANSPARENT_PEN);
+        ctx.SetBrush(wxBrush(m_background));
+        ctx.DrawRectangle(0, 0, size.GetWidth(), size.GetHeight());
+        if (!m_path->IsEmpty()) {
+            m_rightX = m_path->Back().m_x;
+            StrokeFrom(ctx, FirstVisible(), size);
+        }
+        m_valid = false;    // m_rightX no longer matches the cached frame
+        return;
+    }
+
+    const uint64_t appended = m_path->GetAppendedCount();
+    const double pixelsPerX = size.GetWidth() / m_xSpan;
+
+    // The last sample drawn must still be there to join the new ones to it
+    bool full = !m_valid || size != m_size || m_path->IsEmpty() ||
+                m_drawn == 0 || m_drawn - 1 < m_path->GetFirstSequence() || m_drawn > appended;
+
+    int shift = 0;
+    if (!full && appended > m_drawn) {
+        const double lastDrawnX = m_path->AtSequence(m_drawn - 1).m_x;
+        // Whole pixels, rounded up so that the newest sample is never clipped
+        const double move = std::ceil((m_path->Back().m_x - m_rightX) * pixelsPerX);
+        if (m_path->Back().m_x < lastDrawnX || move >= size.GetWidth()) full = true;
+        else shift = static_cast<int>(std::max(0.0, move));
+    }
+
+    if (full) {
+        m_size = size;
+        m_rightX = m_path->IsEmpty() ? 0.0 : m_path->Back().m_x;
+        RedrawFrame();
+    } else if (appended > m_drawn) {
+        if (shift > 0) {
+            ScrollFrame(shift);
+            m_rightX += shift / pixelsPerX;
+        }
+        wxMemoryDC dc(m_frame);
+        {
+            fxDrawingContext frameCtx(&dc);
+            StrokeFrom(frameCtx, m_drawn - 1, m_size);
+        }
+        dc.SelectObject(wxNullBitmap);
+        m_incremental = true;
+    }
+
+    m_drawn = appended;
+    m_valid = true;
+    ctx.DrawBitmap(m_frame, 0, 0, size.GetWidth(), size.GetHeight());
+}
@@ -0,0 +1,121 @@
+// fxStreamingPath.hpp
+
+#ifndef FXSTREAMINGPATH_HPP
+#define FXSTREAMINGPATH_HPP
+
+#include <cstdint>
+#include <vector>
+#include <wx/bitmap.h>
+#include <wx/geometry.h>
+#include <wx/pen.h>
+#include "fxDrawingContext.hpp"
+#include "fxGraphicsPath.hpp"
+
+// Append-only polyline over a fixed window of samples.
+//
+// Samples live in a ring buffer of GetCapacity() points: appending to a full
+// buffer drops the oldest sample, so memory and per-sample cost stay constant
+// however long the acquisition runs. Every sample gets a sequence number (the
+// count of samples appended before it), which lets renderers tell which
+// samples they already drew.
+class fxStreamingPath
+{
+public:
+    explicit fxStreamingPath(size_t capacity = 4096);
+
+    // Changing the capacity drops all samples
+    void SetCapacity(size_t capacity);
+    size_t GetCapacity() const { return m_ring.size(); }
+
+    size_t GetSize() const { return m_size; }
+    bool IsEmpty() const { return m_size == 0; }
+    void Clear();
+
+    void Append(const wxPoint2DDouble& point);
+    void Append(wxDouble x, wxDouble y) { Append(wxPoint2DDouble(x, y)); }
+    void Append(const wxPoint2DDouble* points, size_t n);
+
+    // Retained samples, oldest first
+    const wxPoint2DDouble& operator[](size_t i) const { return m_ring[(m_first + i) % m_ring.size()]; }
+    const wxPoint2DDouble& Front() const { return (*this)[0]; }
+    const wxPoint2DDouble& Back() const { return (*this)[m_size - 1]; }
+
+    // Sequence numbers: [GetFirstSequence(), GetAppendedCount()) are retained
+    uint64_t GetAppendedCount() const { return m_appended; }
+    uint64_t GetFirstSequence() const { return m_appended - m_size; }
+    const wxPoint2DDouble& AtSequence(uint64_t sequence) const { return (*this)[size_t(sequence - GetFirstSequence())]; }
+
+    // Retained samples as one polyline (for targets that need a path)
+    fxGraphicsPath ToPath() const;
+
+private:
+    std::vector<wxPoint2DDouble> m_ring;
+    size_t   m_first = 0;       // ring index of the oldest sample
+    size_t   m_size = 0;
+    uint64_t m_appended = 0;
+};
+
+// Real-time scrolling view of an fxStreamingPath.
+//
+// The newest sample sits at the right edge and the view spans the last
+// GetXSpan() data units. On raster targets the previous frame is kept: each
+// render scrolls its pixels left by the whole number of pixels the data moved
+// (a blit), clears the uncovered strip and strokes only the samples appended
+// since, so the cost follows the append rate rather than the window length.
+// A full redraw happens on the first render, on a size, span or range change,
+// when x goes backwards, when the data moved a whole width, or when samples
+// were dropped from the ring before being drawn. Vector targets always get
+// the whole visible polyline.
+class fxStreamingPlot
+{
+public:
+    explicit fxStreamingPlot(const fxStreamingPath* path = nullptr);
+
+    // Samples to show (not owned)
+    void SetPath(const fxStreamingPath* path) { m_path = path; Invalidate(); }
+
+    void SetPen(const wxPen& pen) { m_pen = pen; Invalidate(); }
+    void SetBackground(const wxColour& colour) { m_background = colour; Invalidate(); }
+
+    // Visible window: the last span data units of x, y between min and max
+    void SetXSpan(double span);
+    double GetXSpan() const { return m_xSpan; }
+    void SetYRange(double min, double max);
+
+    // Redraw everything on the next render
+    void Invalidate() { m_valid = false; }
+
+    // Draw the view at (0, 0) with the given device size
+    void Render(fxDrawingContext& ctx, const wxSize& size);
+
+    // Whether the last raster render scrolled the previous frame
+    bool WasIncremental() const { return m_incremental; }
+
+private:
+    const fxStreamingPath* m_path = nullptr;
+    wxPen    m_pen = *wxBLACK_PEN;
+    wxColour m_background = *wxWHITE;
+    double   m_xSpan = 1.0;
+    double   m_yMin = 0.0;
+    double   m_yMax = 1.0;
+
+    // Previous frame and the bitmap it is scrolled into
+    wxBitmap m_frame;
+    wxBitmap m_spare;
+    wxSize   m_size;
+    bool     m_valid = false;
+    bool     m_incremental = false;
+    double   m_rightX = 0.0;    // data x at the right edge of m_frame
+    uint64_t m_drawn = 0;       // samples appended when m_frame was last updated
+
+    std::vector<wxPoint2DDouble> m_points;  // device points being stroked
+
+    wxPoint2DDouble ToDevice(const wxPoint2DDouble& p, const wxSize& size) const;
+    // Sequence of the first sample to stroke for the whole window
+    uint64_t FirstVisible() const;
+    void StrokeFrom(fxDrawingContext& ctx, uint64_t sequence, const wxSize& size);
+    void RedrawFrame();
+    void ScrollFrame(int pixels);
+};
+
+#endif // FXSTREAMINGPATH_HPP
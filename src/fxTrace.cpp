@@ -0,0 +1,170 @@
+// fxTrace.cpp
+#include "fxTrace.hpp"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+
+int64_t SteadyNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void WriteJsonString(std::ostream& out, const char* s)
+{
+    out << '"';
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') out << '\\';
+        out << *s;
+    }
+    out << '"';
+}
+
+} // namespace
+
+fxTracer& fxTracer::Get()
+{
+    static fxTracer tracer;
+    return tracer;
+}
+
+fxTracer::fxTracer() : m_epoch(SteadyNs())
+{
+}
+
+int64_t fxTracer::Now() const
+{
+    return SteadyNs() - m_epoch;
+}
+
+void fxTracer::Start()
+{
+    // Buffers notice the new generation and restart empty
+    m_generation.fetch_add(1, std::memory_order_relaxed);
+    m_enabled.store(true, std::memory_order_relaxed);
+}
+
+//--------------------------------------
+// Per-thread buffers
+//--------------------------------------
+fxTracer::ThreadBuffer& fxTracer::GetThreadBuffer()
+{
+    // Buffers live as long as the tracer, so events of finished threads
+    // are still written out
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = m_buffers.back().get();
+        buffer->tid = static_cast<int>(m_buffers.size());
+    }
+    return *buffer;
+}
+
+void fxTracer::Record(const char* category, const char* name, int64_t startNs, int64_t endNs)
+{
+    if (!IsEnabled()) return;
+
+    ThreadBuffer& buffer = GetThreadBuffer();
+
+    const uint32_t generation = m_generation.load(std::memory_order_relaxed);
+    if (buffer.generation.load(std::memory_order_relaxed) != generation) {
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.dropped.store(0, std::memory_order_relaxed);
+        buffer.generation.store(generation, std::memory_order_release);
+    }
+
+    // Only this thread writes the buffer: no compare-and-swap needed
+    const size_t n = buffer.count.load(std::memory_order_relaxed);
+    if (n >= BUFFER_EVENTS) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[n] = {category, name, startNs, endNs - startNs};
+    buffer.count.store(n + 1, std::memory_order_release);
+}
+
+size_t fxTracer::GetEventCount() const
+{
+    const uint32_t generation = m_generation.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t n = 0;
+    for (const auto& buffer : m_buffers) {
+        if (buffer->generation.load(std::memory_order_acquire) == generation) {
+            n += buffer->count.load(std::memory_order_acquire);
+        }
+    }
+    return n;
+}
+
+size_t fxTracer::GetDroppedCount() const
+{
+    const uint32_t generation = m_generation.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t n = 0;
+    for (const auto& buffer : m_buffers) {
+        if (buffer->generation.load(std::memory_order_acquire) == generation) {
+            n += buffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    return n;
+}
+
+//--------------------------------------
+// Chrome trace-event JSON
+//--------------------------------------
+void fxTracer::WriteChromeTrace(std::ostream& out) const
+{
+    const uint32_t generation = m_generation.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Microseconds with nanosecond digits, whatever the stream settings
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+
+    for (const auto& buffer : m_buffers)
+    {
+        if (buffer->generation.load(std::memory_order_acquire) != generation) continue;
+        const size_t count = buffer->count.load(std::memory_order_acquire);
+        if (count == 0) continue;
+
+        // Thread name metadata
+        out << (first ? "" : ",\n")
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+            << ",\"args\":{\"name\":\"thread " << buffer->tid << "\"}}";
+        first = false;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const fxTraceEvent& e = buffer->events[i];
+            out << ",\n{\"name\":";
+            WriteJsonString(out, e.name);
+            out << ",\"cat\":";
+            WriteJsonString(out, e.category);
+            out << ",\"ph\":\"X\",\"ts\":" << e.startNs / 1000.0
+                << ",\"dur\":" << e.durationNs / 1000.0
+                << ",\"pid\":1,\"tid\":" << buffer->tid << '}';
+        }
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+bool fxTracer::WriteChromeTrace(const wxString& filename) const
+{
+    std::ofstream out(filename.ToStdString(), std::ios::binary);
+    if (!out) return false;
+    WriteChromeTrace(out);
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,131 @@
+// fxTrace.hpp
+
+#ifndef FXTRACE_HPP
+#define FXTRACE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include <wx/string.h>
+
+// Timeline tracing in the Chrome trace-event format (chrome://tracing,
+// ui.perfetto.dev). The FX_TRACE_* macros only record anything when the
+// code is built with FX_ENABLE_TRACE and the tracer is started at run time.
+//
+// Every thread appends complete ("X") events to its own fixed-size buffer
+// without locking; the writer reads the published part of each buffer.
+// Names and categories must be string literals (only the pointers are kept).
+
+// Event categories
+namespace fxTraceCategory {
+    constexpr const char* Frame   = "frame";
+    constexpr const char* Layer   = "layer";
+    constexpr const char* Path    = "path";
+    constexpr const char* Text    = "text";
+    constexpr const char* Backend = "backend";
+    constexpr const char* Encode  = "encode";
+}
+
+struct fxTraceEvent
+{
+    const char* category;
+    const char* name;
+    int64_t     startNs;
+    int64_t     durationNs;
+};
+
+class fxTracer
+{
+public:
+    // Events kept per thread; later events are dropped and counted
+    static constexpr size_t BUFFER_EVENTS = 1 << 16;
+
+    static fxTracer& Get();
+
+    // Clear the buffers and start recording
+    void Start();
+    void Stop() { m_enabled.store(false, std::memory_order_relaxed); }
+    bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Nanoseconds since the tracer was created
+    int64_t Now() const;
+
+    // Record an event of the calling thread
+    void Record(const char* category, const char* name, int64_t startNs, int64_t endNs);
+
+    // Write all recorded events as trace JSON
+    void WriteChromeTrace(std::ostream& out) const;
+    bool WriteChromeTrace(const wxString& filename) const;
+
+    size_t GetEventCount() const;
+    size_t GetDroppedCount() const;
+
+private:
+    struct ThreadBuffer
+    {
+        int tid = 0;
+        std::unique_ptr<fxTraceEvent[]> events{new fxTraceEvent[BUFFER_EVENTS]};
+        std::atomic<size_t> count{0};     // published events
+        std::atomic<size_t> dropped{0};
+        std::atomic<uint32_t> generation{0};
+    };
+
+    fxTracer();
+    ThreadBuffer& GetThreadBuffer();
+
+    std::atomic<bool>     m_enabled{false};
+    std::atomic<uint32_t> m_generation{0};   // bumped by Start(), buffers reset lazily
+    int64_t               m_epoch;
+
+    mutable std::mutex m_mutex;               // guards m_buffers (registration only)
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+};
+
+// Records the lifetime of a scope
+class fxTraceScope
+{
+public:
+    fxTraceScope(const char* category, const char* name)
+        : m_category(category), m_name(name),
+          m_start(fxTracer::Get().IsEnabled() ? fxTracer::Get().Now() : -1) {}
+
+    ~fxTraceScope()
+    {
+        if (m_start >= 0) {
+            fxTracer& tracer = fxTracer::Get();
+            tracer.Record(m_category, m_name, m_start, tracer.Now());
+        }
+    }
+
+    fxTraceScope(const fxTraceScope&) = delete;
+    fxTraceScope& operator=(const fxTraceScope&) = delete;
+
+private:
+    const char* m_category;
+    const char* m_name;
+    int64_t     m_start;
+};
+
+#ifdef FX_ENABLE_TRACE
+
+#define FX_TRACE_CONCAT_(a, b) a##b
+#define FX_TRACE_CONCAT(a, b)  FX_TRACE_CONCAT_(a, b)
+
+#define FX_TRACE_SCOPE(category, name) \
+    fxTraceScope FX_TRACE_CONCAT(fxTraceScope_, __LINE__)(fxTraceCategory::category, name)
+#define FX_TRACE_NOW()                 (fxTracer::Get().IsEnabled() ? fxTracer::Get().Now() : -1)
+#define FX_TRACE_RECORD(category, name, startNs) \
+    do { if ((startNs) >= 0) fxTracer::Get().Record(fxTraceCategory::category, name, (startNs), fxTracer::Get().Now()); } while (0)
+
+#else
+
+#define FX_TRACE_SCOPE(category, name)           ((void)0)
+#define FX_TRACE_NOW()                           (int64_t(-1))
+#define FX_TRACE_RECORD(category, name, startNs) ((void)0)
+
+#endif // FX_ENABLE_TRACE
+
+#endif // FXTRACE_HPP